@@ -0,0 +1,395 @@
+#include "audio_file.h"
+#include "../dsp/channel_layout.h"
+#include "lossless.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+struct AudioFile {
+    const uint8_t* map;
+    size_t map_size;
+#ifdef _WIN32
+    HANDLE file_handle;
+    HANDLE mapping;
+#endif
+    const uint8_t* data;                /* first sample frame */
+    uint32_t frame_bytes;
+    AudioFileInfo_t info;
+    uint64_t cursor;
+
+    AudioBuffer_t buffer;
+    float* scratch;                     /* integer formats and ODLC only */
+    uint32_t scratch_frames;
+
+    /* ODLC: block offsets and first frames (num_blocks + 1 entries),
+     * plus the most recently decoded block. */
+    int lossless;
+    uint32_t num_blocks;
+    uint64_t* block_offset;
+    uint64_t* block_first;
+    float* decoded;
+    uint32_t decoded_capacity;          /* frames */
+    int64_t decoded_block;
+};
+
+static uint32_t sample_bytes(AudioSampleFormat_t format) {
+    switch (format) {
+        case AUDIO_SAMPLE_F32: return 4;
+        case AUDIO_SAMPLE_S16: return 2;
+        case AUDIO_SAMPLE_S24: return 3;
+    }
+    return 0;
+}
+
+int OD_AudioFile_ParseFormat(const char* name, AudioSampleFormat_t* format) {
+    if (!name || !format) return 0;
+    if (strcmp(name, "f32") == 0) *format = AUDIO_SAMPLE_F32;
+    else if (strcmp(name, "s16") == 0) *format = AUDIO_SAMPLE_S16;
+    else if (strcmp(name, "s24") == 0) *format = AUDIO_SAMPLE_S24;
+    else return 0;
+    return 1;
+}
+
+/* ──────────────────── Mapping ──────────────────── */
+
+static int map_file(AudioFile_t* f, const char* path) {
+#ifdef _WIN32
+    f->file_handle = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+                                 FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (f->file_handle == INVALID_HANDLE_VALUE) return 0;
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(f->file_handle, &size) || size.QuadPart == 0) return 0;
+    f->mapping = CreateFileMappingA(f->file_handle, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (!f->mapping) return 0;
+    f->map = (const uint8_t*)MapViewOfFile(f->mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!f->map) return 0;
+    f->map_size = (size_t)size.QuadPart;
+    return 1;
+#else
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return 0;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0) {
+        close(fd);
+        return 0;
+    }
+    void* p = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (p == MAP_FAILED) return 0;
+    madvise(p, (size_t)st.st_size, MADV_SEQUENTIAL);
+    f->map = (const uint8_t*)p;
+    f->map_size = (size_t)st.st_size;
+    return 1;
+#endif
+}
+
+static void unmap_file(AudioFile_t* f) {
+#ifdef _WIN32
+    if (f->map) UnmapViewOfFile(f->map);
+    if (f->mapping) CloseHandle(f->mapping);
+    if (f->file_handle && f->file_handle != INVALID_HANDLE_VALUE) CloseHandle(f->file_handle);
+#else
+    if (f->map) munmap((void*)f->map, f->map_size);
+#endif
+    f->map = NULL;
+}
+
+/* ──────────────────── WAV header ──────────────────── */
+
+static uint16_t rd16(const uint8_t* p) { return (uint16_t)(p[0] | (p[1] << 8)); }
+static uint32_t rd32(const uint8_t* p) { return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24); }
+
+#define WAVE_TAG_PCM        0x0001
+#define WAVE_TAG_FLOAT      0x0003
+#define WAVE_TAG_EXTENSIBLE 0xFFFE
+
+static int parse_wav(AudioFile_t* f) {
+    const uint8_t* p = f->map;
+    size_t size = f->map_size;
+    if (size < 12 || memcmp(p, "RIFF", 4) != 0 || memcmp(p + 8, "WAVE", 4) != 0) return 0;
+
+    int have_fmt = 0;
+    uint32_t mask = 0;
+    size_t pos = 12;
+    while (pos + 8 <= size) {
+        const uint8_t* chunk = p + pos;
+        uint32_t len = rd32(chunk + 4);
+        size_t body = pos + 8;
+
+        if (memcmp(chunk, "fmt ", 4) == 0 && len >= 16 && body + len <= size) {
+            uint16_t tag = rd16(p + body);
+            uint16_t bits = rd16(p + body + 14);
+            f->info.channels = rd16(p + body + 2);
+            f->info.sample_rate = rd32(p + body + 4);
+            if (tag == WAVE_TAG_EXTENSIBLE && len >= 40) {
+                mask = rd32(p + body + 20);
+                tag = rd16(p + body + 24);      /* first two bytes of SubFormat */
+            }
+            if (tag == WAVE_TAG_FLOAT && bits == 32) f->info.format = AUDIO_SAMPLE_F32;
+            else if (tag == WAVE_TAG_PCM && bits == 16) f->info.format = AUDIO_SAMPLE_S16;
+            else if (tag == WAVE_TAG_PCM && bits == 24) f->info.format = AUDIO_SAMPLE_S24;
+            else {
+                printf("[Audio File] Unsupported WAV encoding (tag 0x%04X, %u bits)\n", tag, bits);
+                return 0;
+            }
+            have_fmt = 1;
+        } else if (memcmp(chunk, "data", 4) == 0 && have_fmt) {
+            /* A header that was never finalised (size 0 or 0xFFFFFFFF)
+             * runs to the end of the file. */
+            size_t avail = size - body;
+            size_t bytes = (len == 0 || len == 0xFFFFFFFFu || len > avail) ? avail : len;
+            f->data = p + body;
+            f->frame_bytes = f->info.channels * sample_bytes(f->info.format);
+            if (f->frame_bytes == 0) return 0;
+            f->info.frames = bytes / f->frame_bytes;
+
+            ChannelMap_t map;
+            if (mask) od_channel_map_from_wave_mask(mask, f->info.channels, &map);
+            else od_channel_map_default(f->info.channels, &map);
+            memcpy(f->info.position, map.position, sizeof(f->info.position));
+            return 1;
+        }
+        pos = body + len + (len & 1);
+    }
+    return 0;
+}
+
+/* ──────────────────── ODLC ──────────────────── */
+
+static uint64_t rd64(const uint8_t* p) { return (uint64_t)rd32(p) | ((uint64_t)rd32(p + 4) << 32); }
+
+static int add_block(AudioFile_t* f, uint64_t offset, uint32_t* capacity) {
+    uint32_t frames = 0;
+    if (offset >= f->map_size) return 0;
+    if (od_lossless_block_size(f->map + offset, f->map_size - offset, &frames) == 0 || frames == 0) return 0;
+
+    if (f->num_blocks + 1 >= *capacity) {
+        uint32_t grown = *capacity * 2;
+        uint64_t* offsets = (uint64_t*)realloc(f->block_offset, (size_t)grown * sizeof(uint64_t));
+        if (!offsets) return 0;
+        f->block_offset = offsets;
+        uint64_t* firsts = (uint64_t*)realloc(f->block_first, (size_t)grown * sizeof(uint64_t));
+        if (!firsts) return 0;
+        f->block_first = firsts;
+        *capacity = grown;
+    }
+    f->block_offset[f->num_blocks] = offset;
+    f->block_first[f->num_blocks + 1] = f->block_first[f->num_blocks] + frames;
+    if (frames > f->decoded_capacity) f->decoded_capacity = frames;
+    f->num_blocks++;
+    return 1;
+}
+
+static int parse_odlc(AudioFile_t* f) {
+    LosslessHeader_t header;
+    if (!od_lossless_read_header(f->map, f->map_size, &header)) return 0;
+    if (header.channels > OD_MAX_CHANNELS) return 0;
+
+    uint32_t capacity = 1024;
+    f->block_offset = (uint64_t*)malloc(capacity * sizeof(uint64_t));
+    f->block_first = (uint64_t*)malloc(capacity * sizeof(uint64_t));
+    if (!f->block_offset || !f->block_first) return 0;
+    f->block_first[0] = 0;
+
+    /* Trust the index only if it is complete; a recording whose writer
+     * never finished has none, so walk the block chain instead. */
+    uint64_t idx = header.index_offset;
+    int indexed = idx != 0 && idx + 8 <= f->map_size &&
+                  memcmp(f->map + idx, OD_LOSSLESS_INDEX_MAGIC, 4) == 0 &&
+                  rd32(f->map + idx + 4) == header.num_blocks &&
+                  idx + 8 + (uint64_t)header.num_blocks * 8 <= f->map_size;
+    for (uint32_t i = 0; indexed && i < header.num_blocks; i++) {
+        indexed = add_block(f, rd64(f->map + idx + 8 + 8 * (uint64_t)i), &capacity);
+    }
+    if (!indexed) {
+        f->num_blocks = 0;
+        uint64_t offset = OD_LOSSLESS_HEADER_BYTES;
+        while (add_block(f, offset, &capacity)) offset += rd32(f->map + offset);
+    }
+
+    f->lossless = 1;
+    f->decoded_block = -1;
+    f->data = f->map;
+    f->info.format = AUDIO_SAMPLE_F32;
+    f->info.channels = header.channels;
+    f->info.sample_rate = header.sample_rate;
+    f->info.frames = f->block_first[f->num_blocks];
+    memcpy(f->info.position, header.position, sizeof(f->info.position));
+    return 1;
+}
+
+/* Decodes the block holding `frame` unless it is already cached. */
+static int decode_block_at(AudioFile_t* f, uint64_t frame, uint32_t* block) {
+    uint32_t lo = 0, hi = f->num_blocks;
+    while (hi - lo > 1) {
+        uint32_t mid = (lo + hi) / 2;
+        if (f->block_first[mid] <= frame) lo = mid;
+        else hi = mid;
+    }
+    *block = lo;
+    if (f->decoded_block == (int64_t)lo) return 1;
+
+    if (!f->decoded) {
+        f->decoded = (float*)malloc((size_t)f->decoded_capacity * f->info.channels * sizeof(float));
+        if (!f->decoded) return 0;
+    }
+    uint64_t offset = f->block_offset[lo];
+    if (od_lossless_decode_block(f->map + offset, f->map_size - offset, f->info.channels, f->decoded) == 0) {
+        printf("[Audio File] Corrupt ODLC block %u\n", lo);
+        return 0;
+    }
+    f->decoded_block = lo;
+    return 1;
+}
+
+static int read_lossless(AudioFile_t* f, uint32_t frames, float* dst) {
+    uint32_t ch = f->info.channels;
+    uint64_t frame = f->cursor;
+    while (frames > 0) {
+        uint32_t block;
+        if (!decode_block_at(f, frame, &block)) return 0;
+        uint64_t within = frame - f->block_first[block];
+        uint64_t n = f->block_first[block + 1] - frame;
+        if (n > frames) n = frames;
+        memcpy(dst, f->decoded + within * ch, (size_t)(n * ch) * sizeof(float));
+        dst += n * ch;
+        frame += n;
+        frames -= (uint32_t)n;
+    }
+    return 1;
+}
+
+/* ──────────────────── Instance API ──────────────────── */
+
+AudioFile_t* OD_AudioFile_Open(const char* path, const AudioFileInfo_t* raw) {
+    if (!path) return NULL;
+
+    AudioFile_t* f = (AudioFile_t*)calloc(1, sizeof(AudioFile_t));
+    if (!f) return NULL;
+    if (!map_file(f, path)) {
+        printf("[Audio File] Cannot map %s\n", path);
+        OD_AudioFile_Close(f);
+        return NULL;
+    }
+
+    if (raw) {
+        f->info = *raw;
+        f->data = f->map;
+        f->frame_bytes = raw->channels * sample_bytes(raw->format);
+        if (f->frame_bytes == 0 || raw->sample_rate == 0) {
+            OD_AudioFile_Close(f);
+            return NULL;
+        }
+        f->info.frames = f->map_size / f->frame_bytes;
+        ChannelMap_t map;
+        od_channel_map_default(raw->channels, &map);
+        memcpy(f->info.position, map.position, sizeof(f->info.position));
+    } else if (f->map_size >= OD_LOSSLESS_HEADER_BYTES && memcmp(f->map, OD_LOSSLESS_MAGIC, 4) == 0) {
+        if (!parse_odlc(f)) {
+            printf("[Audio File] %s is not a readable ODLC file\n", path);
+            OD_AudioFile_Close(f);
+            return NULL;
+        }
+    } else if (!parse_wav(f)) {
+        printf("[Audio File] %s is not a readable WAV file\n", path);
+        OD_AudioFile_Close(f);
+        return NULL;
+    }
+
+    if (f->info.channels == 0 || f->info.sample_rate == 0) {
+        OD_AudioFile_Close(f);
+        return NULL;
+    }
+
+    f->buffer.channels = f->info.channels;
+    f->buffer.sample_rate = f->info.sample_rate;
+    f->buffer.format_serial = 1;
+    memcpy(f->buffer.position, f->info.position, sizeof(f->buffer.position));
+    return f;
+}
+
+void OD_AudioFile_Close(AudioFile_t* file) {
+    if (!file) return;
+    unmap_file(file);
+    free(file->scratch);
+    free(file->block_offset);
+    free(file->block_first);
+    free(file->decoded);
+    free(file);
+}
+
+const AudioFileInfo_t* OD_AudioFile_GetInfo(const AudioFile_t* file) {
+    return file ? &file->info : NULL;
+}
+
+int OD_AudioFile_Seek(AudioFile_t* file, uint64_t frame) {
+    if (!file || frame > file->info.frames) return 0;
+    file->cursor = frame;
+    return 1;
+}
+
+uint64_t OD_AudioFile_Tell(const AudioFile_t* file) {
+    return file ? file->cursor : 0;
+}
+
+uint32_t OD_AudioFile_Read(AudioFile_t* file, uint32_t frames, AudioBuffer_t* out) {
+    if (!file || !out || file->cursor >= file->info.frames) return 0;
+
+    uint64_t left = file->info.frames - file->cursor;
+    if (frames > left) frames = (uint32_t)left;
+    const uint8_t* src = file->data + file->cursor * file->frame_bytes;
+    size_t count = (size_t)frames * file->info.channels;
+
+    if (file->lossless) {
+        if (frames > file->scratch_frames) {
+            float* grown = (float*)realloc(file->scratch, count * sizeof(float));
+            if (!grown) return 0;
+            file->scratch = grown;
+            file->scratch_frames = frames;
+        }
+        if (!read_lossless(file, frames, file->scratch)) return 0;
+        file->buffer.buffer = file->scratch;
+    } else if (file->info.format == AUDIO_SAMPLE_F32 && ((uintptr_t)src & 3) == 0) {
+        /* Zero copy: hand out the mapped page cache directly. */
+        file->buffer.buffer = (float*)(uintptr_t)src;
+    } else {
+        if (frames > file->scratch_frames) {
+            float* grown = (float*)realloc(file->scratch, count * sizeof(float));
+            if (!grown) return 0;
+            file->scratch = grown;
+            file->scratch_frames = frames;
+        }
+        float* dst = file->scratch;
+        switch (file->info.format) {
+            case AUDIO_SAMPLE_F32:
+                memcpy(dst, src, count * sizeof(float));
+                break;
+            case AUDIO_SAMPLE_S16:
+                for (size_t i = 0; i < count; i++) {
+                    dst[i] = (float)(int16_t)rd16(src + 2 * i) / 32768.0f;
+                }
+                break;
+            case AUDIO_SAMPLE_S24:
+                for (size_t i = 0; i < count; i++) {
+                    const uint8_t* s = src + 3 * i;
+                    int32_t v = (int32_t)((uint32_t)s[0] << 8 | (uint32_t)s[1] << 16 | (uint32_t)s[2] << 24) >> 8;
+                    dst[i] = (float)v / 8388608.0f;
+                }
+                break;
+        }
+        file->buffer.buffer = dst;
+    }
+
+    file->buffer.num_samples = frames;
+    file->cursor += frames;
+    *out = file->buffer;
+    return frames;
+}
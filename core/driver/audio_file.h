@@ -0,0 +1,63 @@
+#ifndef OD_AUDIO_FILE_H
+#define OD_AUDIO_FILE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "../../include/od_export.h"
+#ifdef _WIN32
+#include "capture_windows.h"
+#else
+#include "capture.h"
+#endif
+
+/* Memory-mapped multichannel audio file: a WAV (PCM int16/int24, IEEE
+ * float32, plain or WAVE_FORMAT_EXTENSIBLE), an ODLC recording (see
+ * lossless.h) or a header-less raw file described by the caller.  Each AudioFile_t owns its mapping and read
+ * cursor, so independent instances can be used from different threads.
+ *
+ * float32 data is served straight from the page cache: the AudioBuffer_t
+ * returned by OD_AudioFile_Read points into the read-only mapping and
+ * must not be written to.  Integer formats are converted, and ODLC blocks
+ * decoded (one cached block per instance), into a per-instance scratch
+ * block. */
+
+typedef enum {
+    AUDIO_SAMPLE_F32 = 0,
+    AUDIO_SAMPLE_S16,
+    AUDIO_SAMPLE_S24
+} AudioSampleFormat_t;
+
+typedef struct {
+    AudioSampleFormat_t format;
+    uint32_t channels;
+    uint32_t sample_rate;
+    uint64_t frames;                        /* filled in by Open */
+    uint8_t position[OD_MAX_CHANNELS];      /* from dwChannelMask, else the standard map */
+} AudioFileInfo_t;
+
+typedef struct AudioFile AudioFile_t;
+
+/* `raw` == NULL parses a WAV or ODLC header; otherwise the whole file is treated
+ * as interleaved samples in raw->format / channels / sample_rate. */
+OD_API AudioFile_t* OD_AudioFile_Open(const char* path, const AudioFileInfo_t* raw);
+OD_API void OD_AudioFile_Close(AudioFile_t* file);
+
+OD_API const AudioFileInfo_t* OD_AudioFile_GetInfo(const AudioFile_t* file);
+OD_API int OD_AudioFile_Seek(AudioFile_t* file, uint64_t frame);
+OD_API uint64_t OD_AudioFile_Tell(const AudioFile_t* file);
+
+/* Serves up to `frames` frames from the cursor and advances it.  `out`
+ * stays valid until the next Read/Close on this file.  Returns the frame
+ * count, 0 at end of file. */
+OD_API uint32_t OD_AudioFile_Read(AudioFile_t* file, uint32_t frames, AudioBuffer_t* out);
+
+/* "f32" / "s16" / "s24" */
+OD_API int OD_AudioFile_ParseFormat(const char* name, AudioSampleFormat_t* format);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
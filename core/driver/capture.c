@@ -0,0 +1,139 @@
+#include "capture_backend.h"
+#include <errno.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+/* ──────────────────── Backend registry ──────────────────── */
+
+static const CaptureBackend_t* const backends[] = {
+#ifdef _WIN32
+    &od_capture_wasapi,
+#else
+    &od_capture_pipewire,
+#endif
+    &od_capture_synth,
+    &od_capture_file,
+};
+
+#define NUM_BACKENDS (sizeof(backends) / sizeof(backends[0]))
+
+static const CaptureBackend_t* active = NULL;
+static char active_args[512];
+
+int OD_Capture_SelectBackend(const char* spec) {
+    if (!spec || !*spec) spec = "native";
+
+    size_t len = strcspn(spec, ":");
+    const CaptureBackend_t* found = NULL;
+    if (len == 6 && strncmp(spec, "native", 6) == 0) {
+        found = backends[0];
+    } else {
+        for (size_t i = 0; i < NUM_BACKENDS; i++) {
+            if (strlen(backends[i]->name) == len && strncmp(spec, backends[i]->name, len) == 0) {
+                found = backends[i];
+                break;
+            }
+        }
+    }
+    if (!found) {
+        printf("[Capture] Unknown backend '%.*s'\n", (int)len, spec);
+        return 0;
+    }
+
+    const char* args = spec[len] == ':' ? spec + len + 1 : "";
+    if (strlen(args) >= sizeof(active_args)) {
+        printf("[Capture] Backend arguments too long\n");
+        return 0;
+    }
+    strcpy(active_args, args);
+    active = found;
+    printf("[Capture] Backend: %s%s%s\n", active->name, *args ? " " : "", args);
+    fflush(stdout);
+    return 1;
+}
+
+const char* OD_Capture_BackendName(void) {
+    return active ? active->name : backends[0]->name;
+}
+
+double od_capture_clock(void) {
+#ifdef _WIN32
+    LARGE_INTEGER freq, now;
+    QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&now);
+    return (double)now.QuadPart / (double)freq.QuadPart;
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec + (double)now.tv_nsec * 1e-9;
+#endif
+}
+
+/* ──────────────────── Block notification ──────────────────── */
+
+static atomic_uint published_sequence;
+static pthread_mutex_t block_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t block_cond = PTHREAD_COND_INITIALIZER;
+
+/* Only the active backend's producer stamps, so reading the counter here
+ * and advancing it in od_capture_notify cannot hand out a number twice. */
+void od_capture_stamp(AudioBuffer_t* buffer) {
+    buffer->timestamp_us = (uint64_t)(od_capture_clock() * 1e6);
+    buffer->sequence = atomic_load_explicit(&published_sequence, memory_order_relaxed) + 1;
+}
+
+void od_capture_notify(const AudioBuffer_t* buffer) {
+    atomic_store_explicit(&published_sequence, buffer->sequence, memory_order_release);
+    /* Signalled without the mutex so the audio thread never blocks; a
+     * waiter that misses it sleeps out its (short) timeout. */
+    pthread_cond_broadcast(&block_cond);
+}
+
+int OD_Capture_WaitForBlock(uint32_t sequence, uint32_t timeout_ms) {
+    if (atomic_load_explicit(&published_sequence, memory_order_acquire) != sequence) return 1;
+
+    struct timespec deadline;
+    timespec_get(&deadline, TIME_UTC);
+    deadline.tv_sec += timeout_ms / 1000;
+    deadline.tv_nsec += (long)(timeout_ms % 1000) * 1000000L;
+    if (deadline.tv_nsec >= 1000000000L) {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000L;
+    }
+
+    pthread_mutex_lock(&block_mutex);
+    while (atomic_load_explicit(&published_sequence, memory_order_acquire) == sequence) {
+        if (pthread_cond_timedwait(&block_cond, &block_mutex, &deadline) == ETIMEDOUT) break;
+    }
+    pthread_mutex_unlock(&block_mutex);
+    return atomic_load_explicit(&published_sequence, memory_order_acquire) != sequence;
+}
+
+/* ──────────────────── Dispatch ──────────────────── */
+
+int OD_Capture_Init(int channels) {
+    if (!active) active = backends[0];
+    return active->init(active_args, channels);
+}
+
+int OD_Capture_Start(void) {
+    if (!active) return 0;
+    return active->start();
+}
+
+void OD_Capture_Stop(void) {
+    if (active) active->stop();
+}
+
+AudioBuffer_t* OD_Capture_GetLatestBuffer(void) {
+    if (!active) return NULL;
+    AudioBuffer_t* buffer = active->get_latest_buffer();
+    if (buffer) od_capture_gate_release(buffer->sequence);
+    return buffer;
+}
@@ -7,6 +7,7 @@ extern "C" {
 
 #include <stdbool.h>
 #include <stdint.h>
+#include "../dsp/dsp_config.h"
 
 
 typedef struct {
@@ -14,10 +15,20 @@ typedef struct {
     uint32_t num_samples; 
     uint32_t channels;    
     uint32_t sample_rate;
+    uint32_t format_serial;                 /* bumped whenever rate/channels/positions change */
+    uint8_t position[OD_MAX_CHANNELS];      /* ChannelPosition_t, all CH_POS_UNKNOWN if not reported */
+    uint32_t gated;                         /* 1 when the silence gate is closed; the DSP skips the block */
+    uint32_t sequence;                      /* bumped for every new block a backend publishes */
+    uint64_t timestamp_us;                  /* monotonic capture time of the block, 0 if unknown */
 } AudioBuffer_t;
 
 
 
+/* Chooses the capture source before OD_Capture_Init: "native" (the
+ * platform backend, default), "pipewire", "synth[:key=value,...]" or
+ * "file:<path>[,key=value,...]". */
+int OD_Capture_SelectBackend(const char* spec);
+const char* OD_Capture_BackendName(void);
 
 int OD_Capture_Init(int channels);
 
@@ -28,9 +39,26 @@ int OD_Capture_Start(void);
 void OD_Capture_Stop(void);
 
 
-
+/* Single consumer.  The returned block is the caller's until its next
+ * call: backends publish new blocks elsewhere and never rewrite it. */
 AudioBuffer_t* OD_Capture_GetLatestBuffer(void);
 
+/* Silence gate, off by default.  Once enabled, blocks are flagged `gated`
+ * after their RMS has stayed below `close_dbfs` for `hold_ms`; the first
+ * block at or above `open_dbfs` reopens it and is kept until read.
+ * OD_Capture_WaitForActivity sleeps while idle, up to `timeout_ms`, and
+ * returns 1 as soon as the gate opens. */
+int  OD_Capture_SetGate(float open_dbfs, float close_dbfs, uint32_t hold_ms);
+void OD_Capture_DisableGate(void);
+int  OD_Capture_IsIdle(void);
+int  OD_Capture_WaitForActivity(uint32_t timeout_ms);
+
+/* Sleeps until a block newer than `sequence` has been published, or
+ * `timeout_ms` passes; returns 1 if one has.  Push backends (PipeWire,
+ * WASAPI) wake the caller immediately; pull backends only produce blocks
+ * inside OD_Capture_GetLatestBuffer, so callers should poll that first. */
+int  OD_Capture_WaitForBlock(uint32_t sequence, uint32_t timeout_ms);
+
 #ifdef __cplusplus
 }
 #endif
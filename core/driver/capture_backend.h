@@ -0,0 +1,61 @@
+#ifndef OD_CAPTURE_BACKEND_H
+#define OD_CAPTURE_BACKEND_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifdef _WIN32
+#include "capture_windows.h"
+#else
+#include "capture.h"
+#endif
+
+/* One capture source.  OD_Capture_* dispatch to the backend chosen with
+ * OD_Capture_SelectBackend(); `args` is the text after "name:" in the
+ * selection spec (empty when none was given). */
+
+typedef struct {
+    const char* name;
+    int (*init)(const char* args, int channels);
+    int (*start)(void);
+    void (*stop)(void);
+    AudioBuffer_t* (*get_latest_buffer)(void);
+} CaptureBackend_t;
+
+#ifdef _WIN32
+extern const CaptureBackend_t od_capture_wasapi;
+#else
+extern const CaptureBackend_t od_capture_pipewire;
+#endif
+extern const CaptureBackend_t od_capture_synth;
+extern const CaptureBackend_t od_capture_file;
+
+/* Monotonic seconds, for backends that pace themselves to wall time. */
+double od_capture_clock(void);
+
+/* od_capture_stamp gives a block about to be published the next sequence
+ * number and the capture time; od_capture_notify announces it once the
+ * consumer can fetch it, waking callers of OD_Capture_WaitForBlock.  A
+ * block that is stamped but never announced leaves its number to the
+ * next one.  Both are safe on the audio thread. */
+void od_capture_stamp(AudioBuffer_t* buffer);
+void od_capture_notify(const AudioBuffer_t* buffer);
+
+/* Silence gate (capture_gate.c).  Backends stamp every new block, run it
+ * through od_capture_gate_feed with its sequence (0 for a block they
+ * drop) and store !result in AudioBuffer_t.gated.  While
+ * od_capture_gate_holding() is true the block that opened the gate has
+ * not been read yet; push backends keep it instead of overwriting it.
+ * The dispatcher releases it once the consumer has fetched that block or
+ * a later one. */
+int  od_capture_gate_feed(const float* samples, uint32_t frames, uint32_t channels, uint32_t sample_rate,
+                          uint32_t sequence);
+int  od_capture_gate_holding(void);
+void od_capture_gate_release(uint32_t sequence);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,155 @@
+#include "capture_backend.h"
+#include "audio_file.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Replays a recording through the capture path.
+ *
+ *   file:match.wav,paced=1,block=512,loop=0
+ *   file:match.raw,format=s16,channels=8,rate=48000
+ *
+ * paced=1 (default) serves the block due at the current wall-clock time,
+ * as a live sink would; paced=0 serves the next block on every call so a
+ * consumer can run as fast as it pulls.  Giving format= opens the file as
+ * header-less raw samples. */
+
+static struct {
+    AudioFile_t* file;
+    uint32_t block;
+    int paced;
+    int loop;
+
+    int running;
+    double started;
+    uint64_t started_frame;
+    uint64_t pulled;            /* frames served in pull mode, across loops */
+    AudioBuffer_t buffer;
+} replay;
+
+static int file_init(const char* args, int channels) {
+    (void)channels;     /* the file decides */
+    OD_AudioFile_Close(replay.file);
+    memset(&replay, 0, sizeof(replay));
+    replay.block = 512;
+    replay.paced = 1;
+
+    char path[512];
+    size_t len = strcspn(args, ",");
+    if (len == 0 || len >= sizeof(path)) {
+        printf("[Capture File] Usage: file:<path>[,key=value...]\n");
+        return 0;
+    }
+    memcpy(path, args, len);
+    path[len] = '\0';
+
+    AudioFileInfo_t raw;
+    memset(&raw, 0, sizeof(raw));
+    int is_raw = 0;
+
+    const char* p = args + len;
+    while (*p) {
+        if (*p == ',') p++;
+        char tok[64];
+        size_t n = strcspn(p, ",");
+        snprintf(tok, sizeof(tok), "%.*s", (int)n, p);
+        p += n;
+
+        char* eq = strchr(tok, '=');
+        if (!eq) continue;
+        *eq = '\0';
+        const char* value = eq + 1;
+        if (strcmp(tok, "block") == 0) replay.block = (uint32_t)atoi(value);
+        else if (strcmp(tok, "paced") == 0) replay.paced = atoi(value);
+        else if (strcmp(tok, "loop") == 0) replay.loop = atoi(value);
+        else if (strcmp(tok, "channels") == 0) raw.channels = (uint32_t)atoi(value);
+        else if (strcmp(tok, "rate") == 0) raw.sample_rate = (uint32_t)atoi(value);
+        else if (strcmp(tok, "format") == 0) {
+            if (!OD_AudioFile_ParseFormat(value, &raw.format)) {
+                printf("[Capture File] Unknown sample format '%s'\n", value);
+                return 0;
+            }
+            is_raw = 1;
+        } else {
+            printf("[Capture File] Ignoring unknown option '%s'\n", tok);
+        }
+    }
+    if (replay.block == 0) return 0;
+    if (is_raw && raw.sample_rate == 0) raw.sample_rate = 48000;
+    if (is_raw && raw.channels == 0) raw.channels = 2;
+
+    replay.file = OD_AudioFile_Open(path, is_raw ? &raw : NULL);
+    if (!replay.file) return 0;
+
+    const AudioFileInfo_t* info = OD_AudioFile_GetInfo(replay.file);
+    printf("[Capture File] %s: %u ch @ %u Hz, %llu frames (%.1f s), %u-frame blocks, %s\n",
+           path, info->channels, info->sample_rate, (unsigned long long)info->frames,
+           (double)info->frames / (double)info->sample_rate, replay.block,
+           replay.paced ? "real-time paced" : "pull mode");
+    fflush(stdout);
+    return 1;
+}
+
+static int file_start(void) {
+    if (!replay.file) return 0;
+    OD_AudioFile_Seek(replay.file, 0);
+    replay.started = od_capture_clock();
+    replay.started_frame = 0;
+    replay.pulled = 0;
+    replay.running = 1;
+    return 1;
+}
+
+static void file_stop(void) {
+    replay.running = 0;
+    OD_AudioFile_Close(replay.file);
+    replay.file = NULL;
+}
+
+static AudioBuffer_t* file_get_latest_buffer(void) {
+    if (!replay.running) return NULL;
+    const AudioFileInfo_t* info = OD_AudioFile_GetInfo(replay.file);
+
+    if (replay.paced) {
+        /* Jump to the block covering "now"; repeat the last one until the
+         * next is due. */
+        double elapsed = od_capture_clock() - replay.started;
+        uint64_t due = (uint64_t)(elapsed * (double)info->sample_rate) / replay.block;
+        if (due == 0) return NULL;
+        uint64_t frame = replay.started_frame + (due - 1) * replay.block;
+        if (replay.buffer.buffer && frame + replay.block <= OD_AudioFile_Tell(replay.file)) {
+            return &replay.buffer;
+        }
+        if (frame >= info->frames) {
+            if (!replay.loop) return NULL;
+            replay.started = od_capture_clock();
+            replay.started_frame = 0;
+            frame = 0;
+        }
+        OD_AudioFile_Seek(replay.file, frame);
+    } else if (OD_AudioFile_Tell(replay.file) >= info->frames) {
+        if (!replay.loop) return NULL;
+        OD_AudioFile_Seek(replay.file, 0);
+    }
+
+    if (OD_AudioFile_Read(replay.file, replay.block, &replay.buffer) == 0) return NULL;
+    od_capture_stamp(&replay.buffer);
+    replay.buffer.gated = !od_capture_gate_feed(replay.buffer.buffer, replay.buffer.num_samples,
+                                                replay.buffer.channels, replay.buffer.sample_rate,
+                                                replay.buffer.sequence);
+    od_capture_notify(&replay.buffer);
+    if (!replay.paced) {
+        /* Pull mode runs faster than real time: stamp stream time instead. */
+        replay.buffer.timestamp_us = (uint64_t)(replay.started * 1e6) + replay.pulled * 1000000u / info->sample_rate;
+        replay.pulled += replay.buffer.num_samples;
+    }
+    return &replay.buffer;
+}
+
+const CaptureBackend_t od_capture_file = {
+    "file",
+    file_init,
+    file_start,
+    file_stop,
+    file_get_latest_buffer,
+};
@@ -0,0 +1,165 @@
+#include "capture_backend.h"
+#include <errno.h>
+#include <math.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <time.h>
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define OD_GATE_SSE 1
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define OD_GATE_NEON 1
+#endif
+
+/* ──────────────────── Silence gate ────────────────────
+ *
+ *  Evaluated by the backends on every new block, on the audio thread:
+ *  one mean-square pass, compared against thresholds kept squared so the
+ *  hot path never takes a log.  Opening is immediate (the loud block
+ *  itself is delivered ungated); closing needs `hold` frames in a row
+ *  below the lower threshold, so decays and short gaps keep the DSP on.
+ */
+
+static struct {
+    atomic_int enabled;
+    _Atomic float open_level;                   /* mean square */
+    _Atomic float close_level;
+    atomic_uint hold_ms;
+
+    atomic_int open;
+    atomic_uint holding;                        /* sequence of the unread onset block, 0 if none */
+    uint64_t quiet_frames;                      /* audio thread only */
+} gate = { 0, 0.0f, 0.0f, 0, 1, 0, 0 };
+
+static pthread_mutex_t wake_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t wake_cond = PTHREAD_COND_INITIALIZER;
+
+static float db_to_mean_square(float dbfs) {
+    return powf(10.0f, dbfs / 10.0f);
+}
+
+static float mean_square(const float* x, size_t n) {
+    size_t i = 0;
+    float sum = 0.0f;
+#if defined(OD_GATE_SSE)
+    __m128 a0 = _mm_setzero_ps(), a1 = _mm_setzero_ps();
+    for (; i + 8 <= n; i += 8) {
+        __m128 v0 = _mm_loadu_ps(x + i);
+        __m128 v1 = _mm_loadu_ps(x + i + 4);
+        a0 = _mm_add_ps(a0, _mm_mul_ps(v0, v0));
+        a1 = _mm_add_ps(a1, _mm_mul_ps(v1, v1));
+    }
+    float lanes[4];
+    _mm_storeu_ps(lanes, _mm_add_ps(a0, a1));
+    sum = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+#elif defined(OD_GATE_NEON)
+    float32x4_t a0 = vdupq_n_f32(0.0f), a1 = vdupq_n_f32(0.0f);
+    for (; i + 8 <= n; i += 8) {
+        float32x4_t v0 = vld1q_f32(x + i);
+        float32x4_t v1 = vld1q_f32(x + i + 4);
+        a0 = vmlaq_f32(a0, v0, v0);
+        a1 = vmlaq_f32(a1, v1, v1);
+    }
+    float lanes[4];
+    vst1q_f32(lanes, vaddq_f32(a0, a1));
+    sum = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+#endif
+    for (; i < n; i++) sum += x[i] * x[i];
+    return n ? sum / (float)n : 0.0f;
+}
+
+int od_capture_gate_feed(const float* samples, uint32_t frames, uint32_t channels, uint32_t sample_rate,
+                         uint32_t sequence) {
+    if (!atomic_load_explicit(&gate.enabled, memory_order_relaxed)) return 1;
+
+    float level = mean_square(samples, (size_t)frames * channels);
+    int open = atomic_load_explicit(&gate.open, memory_order_relaxed);
+
+    if (!open) {
+        if (level < atomic_load_explicit(&gate.open_level, memory_order_relaxed)) return 0;
+        /* Onset: pin this block until the consumer has read it, then wake
+         * a consumer idling in OD_Capture_WaitForActivity.  A block that
+         * will not be published (sequence 0) has nothing to pin. */
+        gate.quiet_frames = 0;
+        if (sequence) atomic_store_explicit(&gate.holding, sequence, memory_order_relaxed);
+        atomic_store_explicit(&gate.open, 1, memory_order_release);
+        pthread_cond_broadcast(&wake_cond);
+        return 1;
+    }
+
+    if (level >= atomic_load_explicit(&gate.close_level, memory_order_relaxed)) {
+        gate.quiet_frames = 0;
+        return 1;
+    }
+    gate.quiet_frames += frames;
+    uint64_t hold = (uint64_t)atomic_load_explicit(&gate.hold_ms, memory_order_relaxed) * sample_rate / 1000;
+    if (gate.quiet_frames < hold) return 1;
+
+    atomic_store_explicit(&gate.open, 0, memory_order_release);
+    return 0;
+}
+
+int od_capture_gate_holding(void) {
+    return atomic_load_explicit(&gate.holding, memory_order_acquire) != 0;
+}
+
+/* A consumer still on a block older than the onset must not unpin it. */
+void od_capture_gate_release(uint32_t sequence) {
+    unsigned pinned = atomic_load_explicit(&gate.holding, memory_order_acquire);
+    if (pinned && (int32_t)(sequence - pinned) >= 0) {
+        atomic_compare_exchange_strong_explicit(&gate.holding, &pinned, 0,
+                                                memory_order_acq_rel, memory_order_relaxed);
+    }
+}
+
+/* ──────────────────── Control ──────────────────── */
+
+int OD_Capture_SetGate(float open_dbfs, float close_dbfs, uint32_t hold_ms) {
+    if (!(open_dbfs < 0.0f) || close_dbfs > open_dbfs) return 0;
+    atomic_store(&gate.open_level, db_to_mean_square(open_dbfs));
+    atomic_store(&gate.close_level, db_to_mean_square(close_dbfs));
+    atomic_store(&gate.hold_ms, hold_ms);
+    atomic_store(&gate.enabled, 1);
+    printf("[Capture] Silence gate: open %.1f dBFS, close %.1f dBFS, hold %u ms\n",
+           open_dbfs, close_dbfs, hold_ms);
+    fflush(stdout);
+    return 1;
+}
+
+void OD_Capture_DisableGate(void) {
+    atomic_store(&gate.enabled, 0);
+    atomic_store(&gate.open, 1);
+    atomic_store(&gate.holding, 0);
+    pthread_cond_broadcast(&wake_cond);
+}
+
+int OD_Capture_IsIdle(void) {
+    return atomic_load_explicit(&gate.enabled, memory_order_relaxed) &&
+           !atomic_load_explicit(&gate.open, memory_order_acquire);
+}
+
+int OD_Capture_WaitForActivity(uint32_t timeout_ms) {
+    if (!OD_Capture_IsIdle()) return 1;
+
+    struct timespec deadline;
+    timespec_get(&deadline, TIME_UTC);
+    deadline.tv_sec += timeout_ms / 1000;
+    deadline.tv_nsec += (long)(timeout_ms % 1000) * 1000000L;
+    if (deadline.tv_nsec >= 1000000000L) {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000L;
+    }
+
+    /* The audio thread signals without the mutex (it must not block), so
+     * a wake-up can slip between the check and the wait; the timeout
+     * bounds that to one idle period, and the pinned onset block means
+     * the transient is still there when we look. */
+    pthread_mutex_lock(&wake_mutex);
+    while (OD_Capture_IsIdle()) {
+        if (pthread_cond_timedwait(&wake_cond, &wake_mutex, &deadline) == ETIMEDOUT) break;
+    }
+    pthread_mutex_unlock(&wake_mutex);
+    return !OD_Capture_IsIdle();
+}
@@ -1,4 +1,5 @@
-#include "capture.h"
+#include "capture_backend.h"
+#include "recorder.h"
 
 #include <pipewire/pipewire.h>
 #include <spa/param/audio/format-utils.h>
@@ -6,13 +7,111 @@
 #include <stdlib.h>
 #include <string.h>
 
+/* Format negotiated with the sink, written by on_param_changed on the
+ * loop thread and read by on_process on the data thread.  `serial` is a
+ * seqlock: odd while the fields are rewritten, even (and nonzero once a
+ * format exists) otherwise.  on_process copies the fields, re-reads the
+ * serial and drops the block if it moved, so a block never pairs one
+ * serial with another format. */
+struct negotiated_format {
+    uint32_t rate;
+    uint32_t channels;
+    uint8_t position[OD_MAX_CHANNELS];
+    uint32_t serial;
+};
+
+#define FRESH 4u   /* flag on `middle`: written since the consumer last swapped */
+
+/* Slots are sized once, off the RT thread, for PipeWire's largest
+ * quantum (clock.max-quantum tops out at 8192) at OD_MAX_CHANNELS.
+ * A block that still does not fit is dropped. */
+#define MAX_QUANTUM 8192
+#define SLOT_FLOATS ((size_t)MAX_QUANTUM * OD_MAX_CHANNELS)
+
 struct data {
     struct pw_thread_loop *loop;
     struct pw_stream *stream;
-    AudioBuffer_t latest_buffer;
+
+    /* Triple buffer: on_process owns `back`, the consumer owns `front`,
+     * and the two trade slots through `middle` with one atomic exchange,
+     * so a block is never rewritten while it is being analysed. */
+    AudioBuffer_t slot[3];
+    unsigned back;
+    unsigned front;
+    unsigned middle;
+
     int channels;
+    struct negotiated_format format;
 };
 
+static uint8_t position_from_spa(uint32_t spa) {
+    switch (spa) {
+        case SPA_AUDIO_CHANNEL_MONO: return CH_POS_MONO;
+        case SPA_AUDIO_CHANNEL_FL:   return CH_POS_FL;
+        case SPA_AUDIO_CHANNEL_FR:   return CH_POS_FR;
+        case SPA_AUDIO_CHANNEL_FC:   return CH_POS_FC;
+        case SPA_AUDIO_CHANNEL_LFE:  return CH_POS_LFE;
+        case SPA_AUDIO_CHANNEL_SL:   return CH_POS_SL;
+        case SPA_AUDIO_CHANNEL_SR:   return CH_POS_SR;
+        case SPA_AUDIO_CHANNEL_FLC:  return CH_POS_FLC;
+        case SPA_AUDIO_CHANNEL_FRC:  return CH_POS_FRC;
+        case SPA_AUDIO_CHANNEL_RC:   return CH_POS_BC;
+        case SPA_AUDIO_CHANNEL_RL:   return CH_POS_BL;
+        case SPA_AUDIO_CHANNEL_RR:   return CH_POS_BR;
+        case SPA_AUDIO_CHANNEL_TC:   return CH_POS_TC;
+        case SPA_AUDIO_CHANNEL_TFL:  return CH_POS_TFL;
+        case SPA_AUDIO_CHANNEL_TFC:  return CH_POS_TFC;
+        case SPA_AUDIO_CHANNEL_TFR:  return CH_POS_TFR;
+        case SPA_AUDIO_CHANNEL_TRL:  return CH_POS_TBL;
+        case SPA_AUDIO_CHANNEL_TRC:  return CH_POS_TBC;
+        case SPA_AUDIO_CHANNEL_TRR:  return CH_POS_TBR;
+        case SPA_AUDIO_CHANNEL_FLW:  return CH_POS_FLW;
+        case SPA_AUDIO_CHANNEL_FRW:  return CH_POS_FRW;
+        case SPA_AUDIO_CHANNEL_LFE2: return CH_POS_LFE2;
+        case SPA_AUDIO_CHANNEL_FLH:  return CH_POS_TFL;
+        case SPA_AUDIO_CHANNEL_FCH:  return CH_POS_TFC;
+        case SPA_AUDIO_CHANNEL_FRH:  return CH_POS_TFR;
+        case SPA_AUDIO_CHANNEL_TSL:  return CH_POS_TSL;
+        case SPA_AUDIO_CHANNEL_TSR:  return CH_POS_TSR;
+        case SPA_AUDIO_CHANNEL_BC:   return CH_POS_BC;
+        default:                     return CH_POS_UNKNOWN;
+    }
+}
+
+static void on_param_changed(void *userdata, uint32_t id, const struct spa_pod *param) {
+    struct data *d = (struct data *)userdata;
+    struct spa_audio_info info;
+
+    if (param == NULL || id != SPA_PARAM_Format)
+        return;
+
+    memset(&info, 0, sizeof(info));
+    if (spa_format_parse(param, &info.media_type, &info.media_subtype) < 0)
+        return;
+    if (info.media_type != SPA_MEDIA_TYPE_audio || info.media_subtype != SPA_MEDIA_SUBTYPE_raw)
+        return;
+    if (spa_format_audio_raw_parse(param, &info.info.raw) < 0)
+        return;
+
+    struct spa_audio_info_raw *raw = &info.info.raw;
+    uint32_t channels = raw->channels;
+    if (channels == 0 || raw->rate == 0)
+        return;
+
+    uint32_t serial = d->format.serial;
+    __atomic_store_n(&d->format.serial, serial + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    __atomic_store_n(&d->format.rate, raw->rate, __ATOMIC_RELAXED);
+    __atomic_store_n(&d->format.channels, channels, __ATOMIC_RELAXED);
+    for (uint32_t c = 0; c < OD_MAX_CHANNELS; c++) {
+        uint8_t position = CH_POS_UNKNOWN;
+        if (!SPA_FLAG_IS_SET(raw->flags, SPA_AUDIO_FLAG_UNPOSITIONED) && c < channels && c < SPA_AUDIO_MAX_CHANNELS)
+            position = position_from_spa(raw->position[c]);
+        __atomic_store_n(&d->format.position[c], position, __ATOMIC_RELAXED);
+    }
+    __atomic_store_n(&d->format.serial, serial + 2, __ATOMIC_RELEASE);
+}
+
 static void on_process(void *userdata) {
     struct data *d = (struct data *)userdata;
     struct pw_buffer *b;
@@ -29,30 +128,65 @@ static void on_process(void *userdata) {
     if ((samples = (float *)buf->datas[0].data) == NULL)
         return;
 
+    /* No Format param yet, or one being rewritten: nothing sensible to analyse. */
+    uint32_t serial = __atomic_load_n(&d->format.serial, __ATOMIC_ACQUIRE);
+    uint32_t channels = __atomic_load_n(&d->format.channels, __ATOMIC_RELAXED);
+    uint32_t rate = __atomic_load_n(&d->format.rate, __ATOMIC_RELAXED);
+    uint8_t position[OD_MAX_CHANNELS];
+    for (uint32_t c = 0; c < OD_MAX_CHANNELS; c++)
+        position[c] = __atomic_load_n(&d->format.position[c], __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    if (serial == 0 || (serial & 1) || __atomic_load_n(&d->format.serial, __ATOMIC_RELAXED) != serial) {
+        pw_stream_queue_buffer(d->stream, b);
+        return;
+    }
+
     n_samples = buf->datas[0].chunk->size / sizeof(float);
+    uint32_t size = buf->datas[0].chunk->size;
+    od_recorder_feed(samples, n_samples / channels, channels, rate, position);
 
-    
-    uint32_t channels = d->channels;
-    if (d->latest_buffer.buffer) {
-        free(d->latest_buffer.buffer);
+    /* A pinned onset block stays in place until the consumer has read it. */
+    if (od_capture_gate_holding()) {
+        od_capture_gate_feed(samples, n_samples / channels, channels, rate, 0);
+        pw_stream_queue_buffer(d->stream, b);
+        return;
     }
-    d->latest_buffer.buffer = malloc(buf->datas[0].chunk->size);
-    memcpy(d->latest_buffer.buffer, samples, buf->datas[0].chunk->size);
-    d->latest_buffer.num_samples = n_samples / channels;
-    d->latest_buffer.channels = channels;
-    d->latest_buffer.sample_rate = 48000;
+
+    AudioBuffer_t *out = &d->slot[d->back];
+    if (n_samples > SLOT_FLOATS) {
+        od_capture_gate_feed(samples, n_samples / channels, channels, rate, 0);
+        pw_stream_queue_buffer(d->stream, b);
+        return;
+    }
+    memcpy(out->buffer, samples, size);
+    out->num_samples = n_samples / channels;
+    out->channels = channels;
+    out->sample_rate = rate;
+    if (out->format_serial != serial) {
+        memcpy(out->position, position, sizeof(out->position));
+        out->format_serial = serial;
+    }
+    /* The gate pins an onset under the sequence it is published with.
+     * Announced only after the exchange, so a consumer woken by the new
+     * sequence finds the block already in `middle`. */
+    od_capture_stamp(out);
+    out->gated = !od_capture_gate_feed(samples, n_samples / channels, channels, rate, out->sequence);
+    d->back = __atomic_exchange_n(&d->middle, d->back | FRESH, __ATOMIC_ACQ_REL) & 3u;
+    od_capture_notify(out);
 
     pw_stream_queue_buffer(d->stream, b);
 }
 
 static const struct pw_stream_events stream_events = {
     PW_VERSION_STREAM_EVENTS,
+    .param_changed = on_param_changed,
     .process = on_process,
 };
 
 static struct data global_data;
 
-int OD_Capture_Init(int channels) {
+static int pipewire_init(const char* args, int channels) {
+    (void)args;
     pw_init(NULL, NULL);
     global_data.loop = pw_thread_loop_new("OD_Capture_Loop", NULL);
     
@@ -78,14 +212,28 @@ int OD_Capture_Init(int channels) {
     struct spa_pod_builder b = SPA_POD_BUILDER_INIT(buffer, sizeof(buffer));
     const struct spa_pod *params[1];
 
-    
+    /* Only the sample format is fixed.  Rate, and channels unless the user
+     * asked for a count, are left open so the sink's native layout is
+     * negotiated and reported back through on_param_changed. */
     global_data.channels = channels;
-    printf("[Capture Linux] Mapping PipeWire stream for %d channels, 48000Hz\n", channels);
-    params[0] = spa_format_audio_raw_build(&b, SPA_PARAM_EnumFormat,
-        &SPA_AUDIO_INFO_RAW_INIT(
-            .format = SPA_AUDIO_FORMAT_F32,
-            .rate = 48000,
-            .channels = channels));
+    global_data.back = 0;
+    global_data.front = 1;
+    global_data.middle = 2;
+    for (int i = 0; i < 3; i++) {
+        if (!global_data.slot[i].buffer) global_data.slot[i].buffer = (float*)malloc(SLOT_FLOATS * sizeof(float));
+        if (!global_data.slot[i].buffer) {
+            printf("[Capture Linux] Could not allocate capture buffers\n");
+            return 0;
+        }
+    }
+    struct spa_audio_info_raw info = SPA_AUDIO_INFO_RAW_INIT(.format = SPA_AUDIO_FORMAT_F32);
+    if (channels > 0) {
+        info.channels = (uint32_t)channels;
+        printf("[Capture Linux] Mapping PipeWire stream for %d channels, native rate\n", channels);
+    } else {
+        printf("[Capture Linux] Mapping PipeWire stream with the sink's native layout and rate\n");
+    }
+    params[0] = spa_format_audio_raw_build(&b, SPA_PARAM_EnumFormat, &info);
     fflush(stdout);
 
     pw_stream_connect(global_data.stream,
@@ -99,13 +247,13 @@ int OD_Capture_Init(int channels) {
     return 1;
 }
 
-int OD_Capture_Start(void) {
+static int pipewire_start(void) {
     printf("[OD Core Linux] Starting PipeWire capture thread...\n");
     pw_thread_loop_start(global_data.loop);
     return 1;
 }
 
-void OD_Capture_Stop(void) {
+static void pipewire_stop(void) {
     printf("[OD Core Linux] Stopping PipeWire capture thread...\n");
     pw_thread_loop_stop(global_data.loop);
     if (global_data.loop) {
@@ -114,7 +262,20 @@ void OD_Capture_Stop(void) {
     }
 }
 
-AudioBuffer_t* OD_Capture_GetLatestBuffer(void) {
-    if (global_data.latest_buffer.buffer == NULL) return NULL;
-    return &global_data.latest_buffer;
+/* Single consumer: the returned block stays untouched until the next call. */
+static AudioBuffer_t* pipewire_get_latest_buffer(void) {
+    struct data *d = &global_data;
+    if (__atomic_load_n(&d->middle, __ATOMIC_ACQUIRE) & FRESH)
+        d->front = __atomic_exchange_n(&d->middle, d->front, __ATOMIC_ACQ_REL) & 3u;
+    /* Nothing published yet: the front slot has never held a block. */
+    if (d->slot[d->front].sequence == 0) return NULL;
+    return &d->slot[d->front];
 }
+
+const CaptureBackend_t od_capture_pipewire = {
+    "pipewire",
+    pipewire_init,
+    pipewire_start,
+    pipewire_stop,
+    pipewire_get_latest_buffer,
+};
@@ -0,0 +1,352 @@
+#include "capture_backend.h"
+#include "../dsp/channel_layout.h"
+#include "recorder.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Deterministic scene generator: N virtual sources panned into a
+ * standard speaker layout.  Every sample is a pure function of its
+ * absolute frame index, so runs are reproducible and paced mode can
+ * skip ahead without generating the blocks it drops.
+ *
+ *   synth:layout=7.1,rate=48000,block=512,paced=0,seed=1,
+ *         src=tone@45/1000/0.5,src=noise@225/4/0.3,src=impulse@300/10/0.8
+ *
+ * Source syntax is kind@azimuth[/param[/amplitude]]:
+ *   tone     param = frequency in Hz
+ *   noise    param = 40 ms bursts per second, 0 = continuous
+ *   impulse  param = clicks per second
+ */
+
+#define PI 3.14159265358979323846
+#define SYNTH_MAX_SOURCES 16
+#define SYNTH_BURST_SECONDS 0.04
+
+typedef enum {
+    SYNTH_TONE = 0,
+    SYNTH_NOISE,
+    SYNTH_IMPULSE
+} SynthKind_t;
+
+typedef struct {
+    SynthKind_t kind;
+    float azimuth;
+    float param;
+    float amplitude;
+    float gain[OD_MAX_CHANNELS];
+} SynthSource_t;
+
+static struct {
+    uint32_t rate;
+    uint32_t block;
+    uint32_t seed;
+    int paced;
+    ChannelMap_t map;
+    uint32_t num_sources;
+    SynthSource_t sources[SYNTH_MAX_SOURCES];
+
+    int running;
+    uint64_t next_frame;        /* absolute frame of the next block to generate */
+    double started;
+    AudioBuffer_t buffer;
+} synth;
+
+/* ──────────────────── Signal ──────────────────── */
+
+/* 32-bit integer hash (lowbias32) → uniform [-1, 1). */
+static float hash_noise(uint32_t seed, uint64_t frame) {
+    uint32_t x = (uint32_t)frame ^ ((uint32_t)(frame >> 32) * 0x9E3779B9u) ^ seed;
+    x ^= x >> 16; x *= 0x7feb352du;
+    x ^= x >> 15; x *= 0x846ca68bu;
+    x ^= x >> 16;
+    return (float)x * (2.0f / 4294967296.0f) - 1.0f;
+}
+
+static float source_sample(const SynthSource_t* s, uint32_t index, uint64_t frame) {
+    double t = (double)frame / (double)synth.rate;
+
+    switch (s->kind) {
+        case SYNTH_TONE: {
+            double phase = fmod((double)s->param * t, 1.0);
+            return s->amplitude * (float)sin(2.0 * PI * phase);
+        }
+        case SYNTH_NOISE: {
+            if (s->param > 0.0f) {
+                double period = 1.0 / (double)s->param;
+                if (fmod(t, period) >= SYNTH_BURST_SECONDS) return 0.0f;
+            }
+            return s->amplitude * hash_noise(synth.seed + index * 0x632BE5ABu, frame);
+        }
+        case SYNTH_IMPULSE: {
+            if (s->param <= 0.0f) return 0.0f;
+            uint64_t period = (uint64_t)((double)synth.rate / (double)s->param);
+            if (period == 0) period = 1;
+            return (frame % period) == 0 ? s->amplitude : 0.0f;
+        }
+    }
+    return 0.0f;
+}
+
+static void generate_block(uint64_t first_frame) {
+    uint32_t ch = synth.map.channels;
+    float* out = synth.buffer.buffer;
+    memset(out, 0, (size_t)synth.block * ch * sizeof(float));
+
+    for (uint32_t n = 0; n < synth.num_sources; n++) {
+        const SynthSource_t* s = &synth.sources[n];
+        for (uint32_t i = 0; i < synth.block; i++) {
+            float v = source_sample(s, n, first_frame + i);
+            if (v == 0.0f) continue;
+            float* frame = out + (size_t)i * ch;
+            for (uint32_t c = 0; c < ch; c++) frame[c] += s->gain[c] * v;
+        }
+    }
+    synth.buffer.num_samples = synth.block;
+    od_recorder_feed(out, synth.block, ch, synth.rate, synth.buffer.position);
+    od_capture_stamp(&synth.buffer);
+    synth.buffer.gated = !od_capture_gate_feed(out, synth.block, ch, synth.rate, synth.buffer.sequence);
+    od_capture_notify(&synth.buffer);
+    if (!synth.paced) {
+        /* Pull mode runs faster than real time: stamp stream time instead. */
+        synth.buffer.timestamp_us = (uint64_t)(synth.started * 1e6) + first_frame * 1000000u / synth.rate;
+    }
+}
+
+/* ──────────────────── Panning ────────────────────
+ *
+ *  Energy (not amplitude) is split between the two ear-level speakers
+ *  bracketing the source, so the energy-weighted vector sum the DSP
+ *  computes lands on the requested azimuth.  Front-only layouts use the
+ *  same L/R energy pan the DSP inverts.
+ */
+
+static void pan_source(SynthSource_t* s, const ChannelGeometry_t* g) {
+    memset(s->gain, 0, sizeof(s->gain));
+    float az = fmodf(s->azimuth, 360.0f);
+    if (az < 0.0f) az += 360.0f;
+
+    if (g->pans) {
+        /* Fold rear azimuths onto the front half-plane: pan = az / 90°. */
+        float a = az > 180.0f ? az - 360.0f : az;
+        if (a > 90.0f) a = 180.0f - a;
+        if (a < -90.0f) a = -180.0f - a;
+        float p = a / 90.0f;
+        for (uint32_t c = 0; c < g->channels; c++) {
+            if (g->mix_l[c] > 0.0f && g->mix_r[c] > 0.0f) {
+                if (g->mix_l[c] == 1.0f) s->gain[c] = 1.0f;   /* mono */
+            } else if (g->mix_l[c] > 0.0f) {
+                s->gain[c] = sqrtf(0.5f * (1.0f - p));
+            } else if (g->mix_r[c] > 0.0f) {
+                s->gain[c] = sqrtf(0.5f * (1.0f + p));
+            }
+        }
+        return;
+    }
+
+    /* Ear-level directional channels, sorted clockwise. */
+    uint32_t ring[OD_MAX_CHANNELS], count = 0;
+    for (uint32_t d = 0; d < g->dir_count; d++) {
+        uint32_t c = g->dir_index[d];
+        if (g->elevation[c] != 0.0f) continue;
+        uint32_t k = count++;
+        while (k > 0 && g->azimuth[ring[k - 1]] > g->azimuth[c]) {
+            ring[k] = ring[k - 1];
+            k--;
+        }
+        ring[k] = c;
+    }
+    if (count == 0) return;
+    if (count == 1) { s->gain[ring[0]] = 1.0f; return; }
+
+    for (uint32_t k = 0; k < count; k++) {
+        uint32_t a = ring[k], b = ring[(k + 1) % count];
+        float span = g->azimuth[b] - g->azimuth[a];
+        if (span <= 0.0f) span += 360.0f;
+        float offset = az - g->azimuth[a];
+        if (offset < 0.0f) offset += 360.0f;
+        if (offset > span) continue;
+
+        /* Solve e_a·v_a + e_b·v_b ∝ s for non-negative energies. */
+        float sx = sinf(az * (float)PI / 180.0f), sy = cosf(az * (float)PI / 180.0f);
+        float det = g->vec_x[a] * g->vec_y[b] - g->vec_x[b] * g->vec_y[a];
+        float ea, eb;
+        if (fabsf(det) < 1e-6f) {
+            ea = 1.0f - offset / span;
+            eb = offset / span;
+        } else {
+            ea = (sx * g->vec_y[b] - sy * g->vec_x[b]) / det;
+            eb = (g->vec_x[a] * sy - g->vec_y[a] * sx) / det;
+            if (ea < 0.0f) ea = 0.0f;
+            if (eb < 0.0f) eb = 0.0f;
+        }
+        float sum = ea + eb;
+        if (sum <= 0.0f) { ea = 1.0f; sum = 1.0f; }
+        s->gain[a] = sqrtf(ea / sum);
+        s->gain[b] = sqrtf(eb / sum);
+        return;
+    }
+}
+
+/* ──────────────────── Arguments ──────────────────── */
+
+static int parse_source(const char* spec, SynthSource_t* s) {
+    char kind[16] = {0};
+    float az = 0.0f, param = 0.0f, amp = 0.5f;
+    int fields = sscanf(spec, "%15[a-z]@%f/%f/%f", kind, &az, &param, &amp);
+    if (fields < 2) return 0;
+
+    memset(s, 0, sizeof(SynthSource_t));
+    if (strcmp(kind, "tone") == 0) {
+        s->kind = SYNTH_TONE;
+        if (fields < 3) param = 1000.0f;
+    } else if (strcmp(kind, "noise") == 0) {
+        s->kind = SYNTH_NOISE;
+        if (fields < 3) param = 0.0f;
+    } else if (strcmp(kind, "impulse") == 0) {
+        s->kind = SYNTH_IMPULSE;
+        if (fields < 3) param = 10.0f;
+    } else {
+        return 0;
+    }
+    s->azimuth = az;
+    s->param = param;
+    s->amplitude = amp;
+    return 1;
+}
+
+static int parse_layout(const char* value, ChannelMap_t* map) {
+    if (strcmp(value, "2.0") == 0) od_channel_map_default(2, map);
+    else if (strcmp(value, "5.1") == 0) od_channel_map_default(6, map);
+    else if (strcmp(value, "7.1") == 0) od_channel_map_default(8, map);
+    else {
+        int n = atoi(value);
+        if (n < 1 || n > OD_MAX_CHANNELS) return 0;
+        od_channel_map_default((uint32_t)n, map);
+    }
+    return 1;
+}
+
+static int parse_args(const char* args) {
+    const char* p = args ? args : "";
+    while (*p) {
+        char tok[128];
+        size_t len = strcspn(p, ",");
+        snprintf(tok, sizeof(tok), "%.*s", (int)len, p);
+        p += len;
+        if (*p == ',') p++;
+        if (tok[0] == '\0') continue;
+
+        char* eq = strchr(tok, '=');
+        if (!eq) {
+            printf("[Capture Synth] Ignoring '%s' (expected key=value)\n", tok);
+            continue;
+        }
+        *eq = '\0';
+        const char* key = tok;
+        const char* value = eq + 1;
+
+        if (strcmp(key, "layout") == 0) {
+            if (!parse_layout(value, &synth.map)) return 0;
+        } else if (strcmp(key, "rate") == 0) {
+            synth.rate = (uint32_t)atoi(value);
+        } else if (strcmp(key, "block") == 0) {
+            synth.block = (uint32_t)atoi(value);
+        } else if (strcmp(key, "paced") == 0) {
+            synth.paced = atoi(value);
+        } else if (strcmp(key, "seed") == 0) {
+            synth.seed = (uint32_t)strtoul(value, NULL, 0);
+        } else if (strcmp(key, "src") == 0) {
+            if (synth.num_sources >= SYNTH_MAX_SOURCES) continue;
+            if (!parse_source(value, &synth.sources[synth.num_sources])) {
+                printf("[Capture Synth] Invalid source '%s'\n", value);
+                return 0;
+            }
+            synth.num_sources++;
+        } else {
+            printf("[Capture Synth] Ignoring unknown option '%s'\n", key);
+        }
+    }
+    return 1;
+}
+
+/* ──────────────────── Backend ──────────────────── */
+
+static int synth_init(const char* args, int channels) {
+    free(synth.buffer.buffer);
+    memset(&synth, 0, sizeof(synth));
+    synth.rate = 48000;
+    synth.block = 512;
+    synth.seed = 1;
+
+    if (!parse_args(args)) return 0;
+    if (synth.map.channels == 0) od_channel_map_default(channels > 0 ? (uint32_t)channels : 2, &synth.map);
+    if (synth.rate == 0 || synth.block == 0) return 0;
+
+    if (synth.num_sources == 0) {
+        parse_source("tone@45/1000/0.5", &synth.sources[0]);
+        parse_source("noise@225/4/0.3", &synth.sources[1]);
+        parse_source("impulse@300/10/0.8", &synth.sources[2]);
+        synth.num_sources = 3;
+    }
+
+    ChannelGeometry_t geom;
+    od_channel_geometry_build(&synth.map, &geom);
+    for (uint32_t n = 0; n < synth.num_sources; n++) pan_source(&synth.sources[n], &geom);
+
+    synth.buffer.buffer = (float*)calloc((size_t)synth.block * synth.map.channels, sizeof(float));
+    if (!synth.buffer.buffer) return 0;
+    synth.buffer.channels = synth.map.channels;
+    synth.buffer.sample_rate = synth.rate;
+    synth.buffer.format_serial = 1;
+    memcpy(synth.buffer.position, synth.map.position, sizeof(synth.buffer.position));
+
+    printf("[Capture Synth] %u sources, %u ch @ %u Hz, %u-frame blocks, %s\n",
+           synth.num_sources, synth.map.channels, synth.rate, synth.block,
+           synth.paced ? "real-time paced" : "pull mode");
+    fflush(stdout);
+    return 1;
+}
+
+static int synth_start(void) {
+    if (!synth.buffer.buffer) return 0;
+    synth.next_frame = 0;
+    synth.started = od_capture_clock();
+    synth.running = 1;
+    return 1;
+}
+
+static void synth_stop(void) {
+    synth.running = 0;
+    free(synth.buffer.buffer);
+    synth.buffer.buffer = NULL;
+}
+
+/* Pull mode: every call yields the next block.  Paced mode: yields the
+ * block covering the current wall-clock time, repeating the last one
+ * until a new block is due. */
+static AudioBuffer_t* synth_get_latest_buffer(void) {
+    if (!synth.running) return NULL;
+
+    uint64_t frame = synth.next_frame;
+    if (synth.paced) {
+        double elapsed = od_capture_clock() - synth.started;
+        uint64_t due = (uint64_t)(elapsed * (double)synth.rate) / synth.block;
+        if (due == 0) return NULL;
+        frame = (due - 1) * synth.block;
+        if (frame + synth.block <= synth.next_frame) return &synth.buffer;
+    }
+
+    generate_block(frame);
+    synth.next_frame = frame + synth.block;
+    return &synth.buffer;
+}
+
+const CaptureBackend_t od_capture_synth = {
+    "synth",
+    synth_init,
+    synth_start,
+    synth_stop,
+    synth_get_latest_buffer,
+};
@@ -7,20 +7,36 @@ extern "C" {
 
 #include <stdbool.h>
 #include <stdint.h>
+#include "../dsp/dsp_config.h"
 
 typedef struct {
     float* buffer;
     uint32_t num_samples; 
     uint32_t channels;    
     uint32_t sample_rate;
+    uint32_t format_serial;                 /* bumped whenever rate/channels/positions change */
+    uint8_t position[OD_MAX_CHANNELS];      /* ChannelPosition_t, all CH_POS_UNKNOWN if not reported */
+    uint32_t gated;                         /* 1 when the silence gate is closed; the DSP skips the block */
+    uint32_t sequence;                      /* bumped for every new block a backend publishes */
+    uint64_t timestamp_us;                  /* monotonic capture time of the block, 0 if unknown */
 } AudioBuffer_t;
 
 
+/* "native", "wasapi", "synth[:key=value,...]" or "file:<path>[,...]"; call before Init. */
+__declspec(dllexport) int OD_Capture_SelectBackend(const char* spec);
+__declspec(dllexport) const char* OD_Capture_BackendName(void);
 __declspec(dllexport) int OD_Capture_Init(int channels);
 __declspec(dllexport) int OD_Capture_Start(void);
 __declspec(dllexport) void OD_Capture_Stop(void);
 __declspec(dllexport) AudioBuffer_t* OD_Capture_GetLatestBuffer(void);
 
+/* Silence gate: see capture.h. */
+__declspec(dllexport) int OD_Capture_SetGate(float open_dbfs, float close_dbfs, uint32_t hold_ms);
+__declspec(dllexport) void OD_Capture_DisableGate(void);
+__declspec(dllexport) int OD_Capture_IsIdle(void);
+__declspec(dllexport) int OD_Capture_WaitForActivity(uint32_t timeout_ms);
+__declspec(dllexport) int OD_Capture_WaitForBlock(uint32_t sequence, uint32_t timeout_ms);
+
 
 #ifdef __cplusplus
 }
@@ -1,5 +1,7 @@
 #ifdef _WIN32
-#include "capture_windows.h"
+#include "capture_backend.h"
+#include "../dsp/channel_layout.h"
+#include "recorder.h"
 #include <windows.h>
 #include <initguid.h>
 #include <mmdeviceapi.h>
@@ -23,6 +25,50 @@ static UINT32 g_current_buf_size = 0;
 static HANDLE capture_thread = NULL;
 static volatile int running = 0;
 static CRITICAL_SECTION buffer_cs;
+static AudioBuffer_t onset_buffer = {0};       /* block that opened the silence gate */
+static UINT32 onset_capacity = 0;
+
+/* Publishes the final mix format with the buffer so the DSP can rebuild
+ * its plan; WASAPI only reports it once, at Initialize. */
+static void publish_format(void) {
+    memset(latest_buffer.position, 0, sizeof(latest_buffer.position));
+    if (pFormat->wFormatTag == WAVE_FORMAT_EXTENSIBLE) {
+        ChannelMap_t map;
+        od_channel_map_from_wave_mask(((WAVEFORMATEXTENSIBLE*)pFormat)->dwChannelMask, pFormat->nChannels, &map);
+        memcpy(latest_buffer.position, map.position, sizeof(latest_buffer.position));
+    }
+    latest_buffer.channels = pFormat->nChannels;
+    latest_buffer.sample_rate = pFormat->nSamplesPerSec;
+    latest_buffer.format_serial++;
+}
+
+/* Publishes the block just written to latest_buffer: stamps its sequence
+ * and runs it through the silence gate.  The block that opens the gate
+ * is copied aside so the consumer still gets it if later packets
+ * overwrite latest_buffer first.  Called with buffer_cs held. */
+static void publish_block(UINT32 numFrames, UINT32 channels) {
+    int was_holding = od_capture_gate_holding();
+    od_capture_stamp(&latest_buffer);
+    od_capture_notify(&latest_buffer);
+    latest_buffer.gated = !od_capture_gate_feed(latest_buffer.buffer, numFrames, channels,
+                                                latest_buffer.sample_rate, latest_buffer.sequence);
+    if (was_holding || !od_capture_gate_holding()) return;
+
+    UINT32 byte_count = numFrames * channels * sizeof(float);
+    if (onset_capacity < byte_count) {
+        float* grown = (float*)realloc(onset_buffer.buffer, byte_count);
+        if (!grown) {
+            od_capture_gate_release(latest_buffer.sequence);
+            return;
+        }
+        onset_buffer.buffer = grown;
+        onset_capacity = byte_count;
+    }
+    float* samples = onset_buffer.buffer;
+    onset_buffer = latest_buffer;
+    onset_buffer.buffer = samples;
+    memcpy(onset_buffer.buffer, latest_buffer.buffer, byte_count);
+}
 
 static DWORD WINAPI CaptureThreadProc(LPVOID lpParam) {
     (void)lpParam;
@@ -77,6 +123,9 @@ static DWORD WINAPI CaptureThreadProc(LPVOID lpParam) {
                     latest_buffer.num_samples = numFrames;
                     latest_buffer.channels = channels;
                     latest_buffer.sample_rate = pFormat->nSamplesPerSec;
+                    od_recorder_feed(latest_buffer.buffer, numFrames, channels,
+                                     latest_buffer.sample_rate, latest_buffer.position);
+                    publish_block(numFrames, channels);
                     LeaveCriticalSection(&buffer_cs);
 
                     
@@ -100,6 +149,9 @@ static DWORD WINAPI CaptureThreadProc(LPVOID lpParam) {
                     EnterCriticalSection(&buffer_cs);
                     memset(latest_buffer.buffer, 0, numFrames * pFormat->nChannels * sizeof(float));
                     latest_buffer.num_samples = numFrames;
+                    od_recorder_feed(latest_buffer.buffer, numFrames, pFormat->nChannels,
+                                     pFormat->nSamplesPerSec, latest_buffer.position);
+                    publish_block(numFrames, pFormat->nChannels);
                     LeaveCriticalSection(&buffer_cs);
                 }
             }
@@ -111,7 +163,8 @@ static DWORD WINAPI CaptureThreadProc(LPVOID lpParam) {
     return 0;
 }
 
-int OD_Capture_Init(int channels) {
+static int wasapi_init(const char* args, int channels) {
+    (void)args;
     InitializeCriticalSection(&buffer_cs);
     HRESULT hr;
     
@@ -199,11 +252,12 @@ int OD_Capture_Init(int channels) {
 
     hr = pAudioClient->lpVtbl->GetService(pAudioClient, &IID_IAudioCaptureClient, (void**)&pCaptureClient);
     if (FAILED(hr)) return hr;
-    
+
+    publish_format();
     return 1;
 }
 
-int OD_Capture_Start(void) {
+static int wasapi_start(void) {
     if (pAudioClient) {
         pAudioClient->lpVtbl->Start(pAudioClient);
         running = 1;
@@ -212,7 +266,7 @@ int OD_Capture_Start(void) {
     return 1;
 }
 
-void OD_Capture_Stop(void) {
+static void wasapi_stop(void) {
     running = 0;
     if (capture_thread) {
         WaitForSingleObject(capture_thread, 2000);
@@ -228,21 +282,25 @@ void OD_Capture_Stop(void) {
     if (latest_buffer.buffer) free(latest_buffer.buffer);
     latest_buffer.buffer = NULL;
     g_current_buf_size = 0;
+    free(onset_buffer.buffer);
+    onset_buffer.buffer = NULL;
+    onset_capacity = 0;
     DeleteCriticalSection(&buffer_cs);
     CoUninitialize();
 }
 
 static AudioBuffer_t ui_buffer = {0};
 
-AudioBuffer_t* OD_Capture_GetLatestBuffer(void) {
+static AudioBuffer_t* wasapi_get_latest_buffer(void) {
     EnterCriticalSection(&buffer_cs);
     if (latest_buffer.buffer == NULL) {
         LeaveCriticalSection(&buffer_cs);
         return NULL;
     }
+    const AudioBuffer_t* src = od_capture_gate_holding() ? &onset_buffer : &latest_buffer;
     
     
-    UINT32 byte_count = latest_buffer.num_samples * latest_buffer.channels * sizeof(float);
+    UINT32 byte_count = src->num_samples * src->channels * sizeof(float);
     if (ui_buffer.buffer == NULL || ui_buffer.num_samples * ui_buffer.channels * sizeof(float) < byte_count) {
         float* new_buf = (float*)realloc(ui_buffer.buffer, byte_count);
         if (new_buf) {
@@ -251,13 +309,28 @@ AudioBuffer_t* OD_Capture_GetLatestBuffer(void) {
     }
     
     if (ui_buffer.buffer) {
-        memcpy(ui_buffer.buffer, latest_buffer.buffer, byte_count);
-        ui_buffer.num_samples = latest_buffer.num_samples;
-        ui_buffer.channels = latest_buffer.channels;
-        ui_buffer.sample_rate = latest_buffer.sample_rate;
+        memcpy(ui_buffer.buffer, src->buffer, byte_count);
+        ui_buffer.num_samples = src->num_samples;
+        ui_buffer.channels = src->channels;
+        ui_buffer.sample_rate = src->sample_rate;
+        ui_buffer.gated = src->gated;
+        ui_buffer.sequence = src->sequence;
+        ui_buffer.timestamp_us = src->timestamp_us;
+        if (ui_buffer.format_serial != src->format_serial) {
+            memcpy(ui_buffer.position, src->position, sizeof(ui_buffer.position));
+            ui_buffer.format_serial = src->format_serial;
+        }
     }
     LeaveCriticalSection(&buffer_cs);
     
     return ui_buffer.buffer ? &ui_buffer : NULL;
 }
+
+const CaptureBackend_t od_capture_wasapi = {
+    "wasapi",
+    wasapi_init,
+    wasapi_start,
+    wasapi_stop,
+    wasapi_get_latest_buffer,
+};
 #endif
@@ -0,0 +1,349 @@
+#include "lossless.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MODE_CONSTANT 0
+#define MODE_VERBATIM 1
+#define MODE_FIXED    2
+
+#define MAX_ORDER         4
+#define MAX_SHIFT         30         /* scaled integers stay within ±2^30 */
+#define RICE_PARTITIONS   8
+#define RICE_PARAM_BITS   5
+#define RICE_ESCAPE       48         /* quotient this long → raw 40-bit value follows */
+
+/* ──────────────────── Byte helpers ──────────────────── */
+
+static void put32(uint8_t* p, uint32_t v) { for (int i = 0; i < 4; i++) p[i] = (uint8_t)(v >> (8 * i)); }
+static void put64(uint8_t* p, uint64_t v) { for (int i = 0; i < 8; i++) p[i] = (uint8_t)(v >> (8 * i)); }
+static uint32_t get32(const uint8_t* p) { return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24); }
+static uint64_t get64(const uint8_t* p) { return (uint64_t)get32(p) | ((uint64_t)get32(p + 4) << 32); }
+
+static uint32_t float_bits(float f) { uint32_t u; memcpy(&u, &f, 4); return u; }
+static float bits_float(uint32_t u) { float f; memcpy(&f, &u, 4); return f; }
+
+void od_lossless_write_header(uint8_t* out, const LosslessHeader_t* h) {
+    memset(out, 0, OD_LOSSLESS_HEADER_BYTES);
+    memcpy(out, OD_LOSSLESS_MAGIC, 4);
+    out[4] = 1;                                 /* version */
+    out[6] = (uint8_t)h->channels;
+    out[7] = (uint8_t)(h->channels >> 8);
+    put32(out + 8, h->sample_rate);
+    put32(out + 12, h->block_frames);
+    put64(out + 16, h->total_frames);
+    put64(out + 24, h->index_offset);
+    put32(out + 32, h->num_blocks);
+    memcpy(out + 36, h->position, OD_MAX_CHANNELS);
+}
+
+int od_lossless_read_header(const uint8_t* in, size_t size, LosslessHeader_t* h) {
+    if (size < OD_LOSSLESS_HEADER_BYTES || memcmp(in, OD_LOSSLESS_MAGIC, 4) != 0 || in[4] != 1) return 0;
+    memset(h, 0, sizeof(LosslessHeader_t));
+    h->channels = (uint32_t)in[6] | ((uint32_t)in[7] << 8);
+    h->sample_rate = get32(in + 8);
+    h->block_frames = get32(in + 12);
+    h->total_frames = get64(in + 16);
+    h->index_offset = get64(in + 24);
+    h->num_blocks = get32(in + 32);
+    memcpy(h->position, in + 36, OD_MAX_CHANNELS);
+    return h->channels > 0 && h->sample_rate > 0;
+}
+
+/* ──────────────────── Bit I/O ──────────────────── */
+
+typedef struct {
+    uint8_t* p;
+    uint64_t acc;
+    int bits;
+} BitWriter_t;
+
+static void bw_put(BitWriter_t* w, uint32_t value, int n) {
+    w->acc = (w->acc << n) | (value & (n == 32 ? 0xFFFFFFFFu : ((1u << n) - 1)));
+    w->bits += n;
+    while (w->bits >= 8) {
+        w->bits -= 8;
+        *w->p++ = (uint8_t)(w->acc >> w->bits);
+    }
+}
+
+static void bw_ones(BitWriter_t* w, uint32_t count) {
+    while (count >= 32) { bw_put(w, 0xFFFFFFFFu, 32); count -= 32; }
+    if (count) bw_put(w, (1u << count) - 1, (int)count);
+}
+
+static void bw_flush(BitWriter_t* w) {
+    if (w->bits > 0) bw_put(w, 0, 8 - w->bits);
+}
+
+typedef struct {
+    const uint8_t* p;
+    const uint8_t* end;
+    uint64_t acc;
+    int bits;
+    int overrun;
+} BitReader_t;
+
+static uint32_t br_get(BitReader_t* r, int n) {
+    while (r->bits < n) {
+        uint8_t byte = 0;
+        if (r->p < r->end) byte = *r->p++;
+        else r->overrun = 1;
+        r->acc = (r->acc << 8) | byte;
+        r->bits += 8;
+    }
+    r->bits -= n;
+    return (uint32_t)(r->acc >> r->bits) & (n == 32 ? 0xFFFFFFFFu : ((1u << n) - 1));
+}
+
+/* Leftover bits of the last byte are padding; continue at the next byte. */
+static const uint8_t* br_align(BitReader_t* r) {
+    return r->p - r->bits / 8;
+}
+
+/* ──────────────────── Rice ──────────────────── */
+
+static uint64_t zigzag(int64_t v) { return ((uint64_t)v << 1) ^ (uint64_t)(v >> 63); }
+static int64_t unzigzag(uint64_t u) { return (int64_t)(u >> 1) ^ -(int64_t)(u & 1); }
+
+static void rice_put(BitWriter_t* w, uint64_t u, int k) {
+    uint64_t q = u >> k;
+    if (q >= RICE_ESCAPE) {
+        bw_ones(w, RICE_ESCAPE);
+        bw_put(w, (uint32_t)(u >> 32), 8);
+        bw_put(w, (uint32_t)u, 32);
+        return;
+    }
+    bw_ones(w, (uint32_t)q);
+    bw_put(w, 0, 1);
+    if (k) bw_put(w, (uint32_t)(u & ((1ull << k) - 1)), k);
+}
+
+static uint64_t rice_get(BitReader_t* r, int k) {
+    uint32_t q = 0;
+    while (q < RICE_ESCAPE && br_get(r, 1)) q++;
+    if (q == RICE_ESCAPE) {
+        uint64_t hi = br_get(r, 8);
+        return (hi << 32) | br_get(r, 32);
+    }
+    uint64_t u = (uint64_t)q << k;
+    if (k) u |= br_get(r, k);
+    return u;
+}
+
+static int rice_param(uint64_t sum, uint32_t n) {
+    int k = 0;
+    while (k < 30 && ((uint64_t)n << (k + 1)) <= sum) k++;
+    return k;
+}
+
+/* ──────────────────── Prediction ──────────────────── */
+
+static int64_t fixed_residual(const int32_t* x, uint32_t i, int order) {
+    switch (order) {
+        case 0: return x[i];
+        case 1: return (int64_t)x[i] - x[i - 1];
+        case 2: return (int64_t)x[i] - 2 * (int64_t)x[i - 1] + x[i - 2];
+        case 3: return (int64_t)x[i] - 3 * (int64_t)x[i - 1] + 3 * (int64_t)x[i - 2] - x[i - 3];
+        default: return (int64_t)x[i] - 4 * (int64_t)x[i - 1] + 6 * (int64_t)x[i - 2] - 4 * (int64_t)x[i - 3] + x[i - 4];
+    }
+}
+
+static int64_t fixed_predict(const int64_t* h, int order) {
+    /* h[0] = x[i-1], h[1] = x[i-2], ... */
+    switch (order) {
+        case 0: return 0;
+        case 1: return h[0];
+        case 2: return 2 * h[0] - h[1];
+        case 3: return 3 * h[0] - 3 * h[1] + h[2];
+        default: return 4 * h[0] - 6 * h[1] + 4 * h[2] - h[3];
+    }
+}
+
+/* Smallest shift S such that every sample is an integer times 2^-S and
+ * fits in ±2^30.  Returns -1 when no such S exists (fractional mixes,
+ * -0.0, NaN/Inf), which sends the channel to verbatim. */
+static int integer_shift(const float* in, uint32_t frames, uint32_t stride) {
+    int need = 0;
+    float peak = 0.0f;
+    for (uint32_t i = 0; i < frames; i++) {
+        float x = in[(size_t)i * stride];
+        uint32_t bits = float_bits(x);
+        if ((bits & 0x7FFFFFFFu) == 0) {
+            if (bits) return -1;                /* -0.0 would decode as +0.0 */
+            continue;
+        }
+        if ((bits & 0x7F800000u) == 0x7F800000u) return -1;
+
+        int e;
+        float m = frexpf(x, &e);
+        int32_t mi = (int32_t)ldexpf(m, 24);
+        uint32_t mag = (uint32_t)(mi < 0 ? -mi : mi);
+        int tz = 0;
+        while (!(mag & 1u)) { mag >>= 1; tz++; }
+        int lsb = e - 24 + tz;
+        if (-lsb > need) need = -lsb;
+        if (need > MAX_SHIFT) return -1;
+
+        float a = fabsf(x);
+        if (a > peak) peak = a;
+    }
+    if (ldexp((double)peak, need) > (double)(1 << MAX_SHIFT)) return -1;
+    return need;
+}
+
+/* ──────────────────── Encoder ──────────────────── */
+
+size_t od_lossless_max_block_bytes(uint32_t frames, uint32_t channels) {
+    /* Worst LPC case: every residual escapes (1 + 48 + 40 bits ≈ 12 bytes). */
+    size_t per_channel = 2 + MAX_ORDER * 4 + RICE_PARTITIONS + (size_t)frames * 12 + 8;
+    return 8 + (size_t)channels * per_channel;
+}
+
+static uint8_t* encode_fixed(const int32_t* x, uint32_t frames, int shift, uint8_t* out) {
+    /* Pick the order with the smallest total |residual|. */
+    uint64_t cost[MAX_ORDER + 1] = {0};
+    for (uint32_t i = MAX_ORDER; i < frames; i++) {
+        for (int o = 0; o <= MAX_ORDER; o++) {
+            int64_t r = fixed_residual(x, i, o);
+            cost[o] += (uint64_t)(r < 0 ? -r : r);
+        }
+    }
+    int order = 0;
+    for (int o = 1; o <= MAX_ORDER; o++) {
+        if (cost[o] < cost[order]) order = o;
+    }
+    if ((uint32_t)order > frames) order = (int)frames;
+
+    *out++ = MODE_FIXED;
+    *out++ = (uint8_t)shift;
+    *out++ = (uint8_t)order;
+
+    BitWriter_t w = { out, 0, 0 };
+    for (int i = 0; i < order; i++) bw_put(&w, (uint32_t)x[i], 32);
+
+    uint32_t count = frames - (uint32_t)order;
+    for (uint32_t p = 0; p < RICE_PARTITIONS; p++) {
+        uint32_t lo = order + (uint32_t)((uint64_t)count * p / RICE_PARTITIONS);
+        uint32_t hi = order + (uint32_t)((uint64_t)count * (p + 1) / RICE_PARTITIONS);
+        uint64_t sum = 0;
+        for (uint32_t i = lo; i < hi; i++) sum += zigzag(fixed_residual(x, i, order));
+        int k = rice_param(sum, hi - lo);
+        bw_put(&w, (uint32_t)k, RICE_PARAM_BITS);
+        for (uint32_t i = lo; i < hi; i++) rice_put(&w, zigzag(fixed_residual(x, i, order)), k);
+    }
+    bw_flush(&w);
+    return w.p;
+}
+
+size_t od_lossless_encode_block(const float* in, uint32_t frames, uint32_t channels, uint8_t* out) {
+    if (frames == 0 || channels == 0) return 0;
+    uint8_t* p = out + 8;
+    int32_t* ints = (int32_t*)malloc((size_t)frames * sizeof(int32_t));
+
+    for (uint32_t c = 0; c < channels; c++) {
+        const float* src = in + c;
+
+        uint32_t first = float_bits(src[0]);
+        uint32_t i = 1;
+        while (i < frames && float_bits(src[(size_t)i * channels]) == first) i++;
+        if (i == frames) {
+            *p++ = MODE_CONSTANT;
+            put32(p, first);
+            p += 4;
+            continue;
+        }
+
+        size_t verbatim_bytes = 1 + (size_t)frames * 4;
+        int shift = ints ? integer_shift(src, frames, channels) : -1;
+        if (shift >= 0) {
+            for (i = 0; i < frames; i++) {
+                ints[i] = (int32_t)ldexp((double)src[(size_t)i * channels], shift);
+            }
+            uint8_t* end = encode_fixed(ints, frames, shift, p);
+            if ((size_t)(end - p) < verbatim_bytes) {
+                p = end;
+                continue;
+            }
+        }
+
+        *p++ = MODE_VERBATIM;
+        for (i = 0; i < frames; i++) {
+            put32(p, float_bits(src[(size_t)i * channels]));
+            p += 4;
+        }
+    }
+    free(ints);
+
+    size_t size = (size_t)(p - out);
+    put32(out, (uint32_t)size);
+    put32(out + 4, frames);
+    return size;
+}
+
+/* ──────────────────── Decoder ──────────────────── */
+
+uint32_t od_lossless_block_size(const uint8_t* in, size_t size, uint32_t* frames) {
+    if (size < 8) return 0;
+    uint32_t bytes = get32(in);
+    if (bytes < 8 || bytes > size) return 0;
+    if (frames) *frames = get32(in + 4);
+    return bytes;
+}
+
+uint32_t od_lossless_decode_block(const uint8_t* in, size_t size, uint32_t channels, float* out) {
+    uint32_t frames = 0;
+    uint32_t bytes = od_lossless_block_size(in, size, &frames);
+    if (bytes == 0 || frames == 0) return 0;
+
+    const uint8_t* p = in + 8;
+    const uint8_t* end = in + bytes;
+
+    for (uint32_t c = 0; c < channels; c++) {
+        if (p >= end) return 0;
+        float* dst = out + c;
+        uint8_t mode = *p++;
+
+        if (mode == MODE_CONSTANT) {
+            if (end - p < 4) return 0;
+            float v = bits_float(get32(p));
+            p += 4;
+            for (uint32_t i = 0; i < frames; i++) dst[(size_t)i * channels] = v;
+        } else if (mode == MODE_VERBATIM) {
+            if ((size_t)(end - p) < (size_t)frames * 4) return 0;
+            for (uint32_t i = 0; i < frames; i++, p += 4) dst[(size_t)i * channels] = bits_float(get32(p));
+        } else if (mode == MODE_FIXED) {
+            if (end - p < 2) return 0;
+            int shift = *p++;
+            int order = *p++;
+            if (order > MAX_ORDER || (uint32_t)order > frames || shift > MAX_SHIFT) return 0;
+
+            BitReader_t r = { p, end, 0, 0, 0 };
+            int64_t hist[MAX_ORDER] = {0};        /* hist[0] = most recent */
+            uint32_t i = 0;
+            for (; i < (uint32_t)order; i++) {
+                int64_t v = (int32_t)br_get(&r, 32);
+                memmove(hist + 1, hist, (MAX_ORDER - 1) * sizeof(int64_t));
+                hist[0] = v;
+                dst[(size_t)i * channels] = (float)ldexp((double)v, -shift);
+            }
+
+            uint32_t count = frames - (uint32_t)order;
+            for (uint32_t part = 0; part < RICE_PARTITIONS; part++) {
+                uint32_t hi = order + (uint32_t)((uint64_t)count * (part + 1) / RICE_PARTITIONS);
+                int k = (int)br_get(&r, RICE_PARAM_BITS);
+                for (; i < hi; i++) {
+                    int64_t v = fixed_predict(hist, order) + unzigzag(rice_get(&r, k));
+                    memmove(hist + 1, hist, (MAX_ORDER - 1) * sizeof(int64_t));
+                    hist[0] = v;
+                    dst[(size_t)i * channels] = (float)ldexp((double)v, -shift);
+                }
+            }
+            if (r.overrun) return 0;
+            p = br_align(&r);
+        } else {
+            return 0;
+        }
+    }
+    return frames;
+}
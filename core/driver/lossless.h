@@ -0,0 +1,62 @@
+#ifndef OD_LOSSLESS_H
+#define OD_LOSSLESS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "../dsp/dsp_config.h"
+#include <stddef.h>
+#include <stdint.h>
+
+/* ODLC: bit-exact float32 multichannel compression for recordings.
+ *
+ *  File:   64-byte header, independent blocks, block index at the end.
+ *  Block:  u32 size, u32 frames, then one section per channel:
+ *            0 constant   every sample has the same bit pattern
+ *            1 verbatim   raw float32 (samples that are not scaled integers)
+ *            2 fixed LPC  samples are int * 2^-shift; FLAC-style fixed
+ *                         predictor (order 0-4) + partitioned Rice residuals
+ *
+ *  Samples decoded from 16/24-bit sources or digital silence take the
+ *  integer path; genuinely fractional float mixes fall back to verbatim.
+ *  Every block decodes on its own, and the index (or, for a file whose
+ *  writer died, a scan of the block sizes) gives random access.
+ */
+
+#define OD_LOSSLESS_MAGIC "ODLC"
+#define OD_LOSSLESS_INDEX_MAGIC "ODIX"
+#define OD_LOSSLESS_HEADER_BYTES 64
+#define OD_LOSSLESS_BLOCK_FRAMES 4096
+
+typedef struct {
+    uint32_t channels;
+    uint32_t sample_rate;
+    uint32_t block_frames;
+    uint64_t total_frames;
+    uint64_t index_offset;      /* 0 while the file is still being written */
+    uint32_t num_blocks;
+    uint8_t position[OD_MAX_CHANNELS];
+} LosslessHeader_t;
+
+void od_lossless_write_header(uint8_t* out, const LosslessHeader_t* header);
+int  od_lossless_read_header(const uint8_t* in, size_t size, LosslessHeader_t* header);
+
+/* Upper bound on an encoded block; size the output for this. */
+size_t od_lossless_max_block_bytes(uint32_t frames, uint32_t channels);
+
+/* Encodes `frames` interleaved frames.  Returns the block size in bytes. */
+size_t od_lossless_encode_block(const float* in, uint32_t frames, uint32_t channels, uint8_t* out);
+
+/* Decodes one block into `out` (interleaved, room for the block's frames).
+ * Returns the frame count, 0 on a malformed block. */
+uint32_t od_lossless_decode_block(const uint8_t* in, size_t size, uint32_t channels, float* out);
+
+/* Size and frame count of the block at `in`, or 0 if none is there. */
+uint32_t od_lossless_block_size(const uint8_t* in, size_t size, uint32_t* frames);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,537 @@
+#include "recorder.h"
+#include "../dsp/dsp_config.h"
+#include "../dsp/channel_layout.h"
+#include "lossless.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+
+#define RING_FLOATS      (1u << 21)             /* 8 MiB: ~5 s of 7.1 at 48 kHz */
+#define SEGMENT_BYTES    (32u << 20)            /* file grows 32 MiB at a time */
+#define PCM_HEADER_BYTES 68u                    /* WAV and CAF headers are both 68 bytes */
+#define FIXUP_SECONDS    1.0
+#define IDLE_SLEEP_MS    10
+
+typedef enum {
+    CONTAINER_WAV = 0,
+    CONTAINER_CAF,
+    CONTAINER_ODLC
+} Container_t;
+
+static struct {
+    /* ── Shared with the audio thread ── */
+    atomic_int active;
+    atomic_int feeding;                         /* audio threads inside od_recorder_feed */
+    float* ring;
+    _Atomic uint64_t head;                      /* written by the audio thread */
+    _Atomic uint64_t tail;                      /* written by the writer thread */
+    atomic_uint channels;                       /* fixed by the first block */
+    atomic_uint sample_rate;
+    uint8_t position[OD_MAX_CHANNELS];          /* valid once channels != 0 */
+    _Atomic uint64_t frames_dropped;
+    atomic_uint overruns;
+    atomic_uint format_changes;
+
+    /* ── Writer thread only ── */
+    pthread_t writer;
+    atomic_int stop;
+    char path[512];
+    Container_t container;
+    uint32_t header_bytes;
+    uint8_t* map;
+    uint64_t mapped;                            /* bytes currently mapped / allocated on disk */
+    uint64_t data_bytes;                        /* audio bytes written after the header */
+    uint64_t trailer_bytes;                     /* ODLC block index, written on close */
+
+    /* ── ODLC encoder ── */
+    float* staging;                             /* one block of interleaved frames */
+    uint32_t staged_frames;
+    uint32_t staged_extra;                      /* samples of a frame split by the ring wrap */
+    uint64_t encoded_frames;
+    uint64_t* index;                            /* file offset of every block */
+    uint32_t index_count;
+    uint32_t index_capacity;
+    uint64_t index_offset;
+#ifdef _WIN32
+    HANDLE file;
+    HANDLE mapping;
+#else
+    int fd;
+#endif
+    _Atomic uint64_t frames_written;
+} rec;
+
+/* ──────────────────── Audio thread ──────────────────── */
+
+static void feed_ring(const float* samples, uint32_t frames, uint32_t channels,
+                      uint32_t sample_rate, const uint8_t* position) {
+    unsigned int fixed = atomic_load_explicit(&rec.channels, memory_order_acquire);
+    if (fixed == 0) {
+        /* First block decides the file format.  position[] is written
+         * before channels is released to the writer. */
+        if (position) memcpy(rec.position, position, sizeof(rec.position));
+        atomic_store_explicit(&rec.sample_rate, sample_rate, memory_order_relaxed);
+        atomic_store_explicit(&rec.channels, channels, memory_order_release);
+        fixed = channels;
+    }
+    if (fixed != channels || atomic_load_explicit(&rec.sample_rate, memory_order_relaxed) != sample_rate) {
+        atomic_fetch_add_explicit(&rec.format_changes, 1, memory_order_relaxed);
+        atomic_fetch_add_explicit(&rec.frames_dropped, frames, memory_order_relaxed);
+        return;
+    }
+
+    uint64_t count = (uint64_t)frames * channels;
+    uint64_t head = atomic_load_explicit(&rec.head, memory_order_relaxed);
+    uint64_t tail = atomic_load_explicit(&rec.tail, memory_order_acquire);
+    if (RING_FLOATS - (head - tail) < count) {
+        atomic_fetch_add_explicit(&rec.overruns, 1, memory_order_relaxed);
+        atomic_fetch_add_explicit(&rec.frames_dropped, frames, memory_order_relaxed);
+        return;
+    }
+
+    uint32_t start = (uint32_t)(head & (RING_FLOATS - 1));
+    uint32_t first = RING_FLOATS - start;
+    if (first > count) first = (uint32_t)count;
+    memcpy(rec.ring + start, samples, first * sizeof(float));
+    memcpy(rec.ring, samples + first, (size_t)(count - first) * sizeof(float));
+    atomic_store_explicit(&rec.head, head + count, memory_order_release);
+}
+
+void od_recorder_feed(const float* samples, uint32_t frames, uint32_t channels,
+                      uint32_t sample_rate, const uint8_t* position) {
+    if (!samples || frames == 0) return;
+
+    /* `feeding` lets Stop wait out a block that saw active == 1 before
+     * the ring is drained for the last time and freed. */
+    atomic_fetch_add_explicit(&rec.feeding, 1, memory_order_acq_rel);
+    if (atomic_load_explicit(&rec.active, memory_order_acquire)) {
+        feed_ring(samples, frames, channels, sample_rate, position);
+    }
+    atomic_fetch_sub_explicit(&rec.feeding, 1, memory_order_release);
+}
+
+/* ──────────────────── File mapping ──────────────────── */
+
+static int map_resize(uint64_t bytes) {
+#ifdef _WIN32
+    if (rec.map) UnmapViewOfFile(rec.map);
+    if (rec.mapping) CloseHandle(rec.mapping);
+    rec.map = NULL;
+    rec.mapping = CreateFileMappingA(rec.file, NULL, PAGE_READWRITE,
+                                     (DWORD)(bytes >> 32), (DWORD)bytes, NULL);
+    if (!rec.mapping) return 0;
+    rec.map = (uint8_t*)MapViewOfFile(rec.mapping, FILE_MAP_WRITE, 0, 0, (SIZE_T)bytes);
+#else
+    if (rec.map) munmap(rec.map, rec.mapped);
+    rec.map = NULL;
+    if (ftruncate(rec.fd, (off_t)bytes) != 0) return 0;
+    void* p = mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, rec.fd, 0);
+    if (p == MAP_FAILED) return 0;
+    rec.map = (uint8_t*)p;
+#endif
+    if (!rec.map) return 0;
+    rec.mapped = bytes;
+    return 1;
+}
+
+static int file_open(void) {
+#ifdef _WIN32
+    rec.file = CreateFileA(rec.path, GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, NULL,
+                           CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (rec.file == INVALID_HANDLE_VALUE) return 0;
+#else
+    rec.fd = open(rec.path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (rec.fd < 0) return 0;
+#endif
+    return map_resize(SEGMENT_BYTES);
+}
+
+static void file_close(void) {
+    uint64_t final_size = rec.header_bytes + rec.data_bytes + rec.trailer_bytes;
+#ifdef _WIN32
+    if (rec.map) {
+        FlushViewOfFile(rec.map, 0);
+        UnmapViewOfFile(rec.map);
+    }
+    if (rec.mapping) CloseHandle(rec.mapping);
+    if (rec.file != INVALID_HANDLE_VALUE) {
+        LARGE_INTEGER size;
+        size.QuadPart = (LONGLONG)final_size;
+        SetFilePointerEx(rec.file, size, NULL, FILE_BEGIN);
+        SetEndOfFile(rec.file);
+        CloseHandle(rec.file);
+    }
+    rec.mapping = NULL;
+    rec.file = INVALID_HANDLE_VALUE;
+#else
+    if (rec.map) {
+        msync(rec.map, rec.mapped, MS_SYNC);
+        munmap(rec.map, rec.mapped);
+    }
+    if (rec.fd >= 0) {
+        if (ftruncate(rec.fd, (off_t)final_size) != 0) {
+            printf("[Recorder] Could not trim %s\n", rec.path);
+        }
+        close(rec.fd);
+    }
+    rec.fd = -1;
+#endif
+    rec.map = NULL;
+    rec.mapped = 0;
+}
+
+/* ──────────────────── Headers ──────────────────── */
+
+static void put16le(uint8_t* p, uint32_t v) { p[0] = (uint8_t)v; p[1] = (uint8_t)(v >> 8); }
+static void put16be(uint8_t* p, uint32_t v) { p[0] = (uint8_t)(v >> 8); p[1] = (uint8_t)v; }
+static void put32le(uint8_t* p, uint32_t v) { for (int i = 0; i < 4; i++) p[i] = (uint8_t)(v >> (8 * i)); }
+static void put32be(uint8_t* p, uint32_t v) { for (int i = 0; i < 4; i++) p[i] = (uint8_t)(v >> (24 - 8 * i)); }
+static void put64be(uint8_t* p, uint64_t v) { for (int i = 0; i < 8; i++) p[i] = (uint8_t)(v >> (56 - 8 * i)); }
+
+static void write_header(void) {
+    uint8_t* h = rec.map;
+    uint32_t ch = atomic_load(&rec.channels);
+    uint32_t rate = atomic_load(&rec.sample_rate);
+
+    if (rec.container == CONTAINER_ODLC) {
+        LosslessHeader_t header;
+        memset(&header, 0, sizeof(header));
+        header.channels = ch;
+        header.sample_rate = rate;
+        header.block_frames = OD_LOSSLESS_BLOCK_FRAMES;
+        header.total_frames = rec.encoded_frames;
+        header.index_offset = rec.index_offset;
+        header.num_blocks = rec.index_count;
+        memcpy(header.position, rec.position, sizeof(header.position));
+        od_lossless_write_header(h, &header);
+        return;
+    }
+
+    if (rec.container == CONTAINER_CAF) {
+        memcpy(h, "caff", 4);
+        put16be(h + 4, 1);                      /* file version */
+        put16be(h + 6, 0);
+        memcpy(h + 8, "desc", 4);
+        put64be(h + 12, 32);
+        union { double d; uint64_t u; } r = { (double)rate };
+        put64be(h + 20, r.u);
+        memcpy(h + 28, "lpcm", 4);
+        put32be(h + 32, 3);                     /* kCAFLinearPCMFormatFlagIsFloat | IsLittleEndian */
+        put32be(h + 36, 4 * ch);
+        put32be(h + 40, 1);
+        put32be(h + 44, ch);
+        put32be(h + 48, 32);
+        memcpy(h + 52, "data", 4);
+        put64be(h + 56, rec.data_bytes + 4);    /* includes the edit count */
+        put32be(h + 64, 0);
+        return;
+    }
+
+    /* WAV sizes saturate past 4 GiB; readers then take "to end of file". */
+    uint64_t riff = PCM_HEADER_BYTES - 8 + rec.data_bytes;
+    uint32_t riff32 = riff > 0xFFFFFFFFu ? 0xFFFFFFFFu : (uint32_t)riff;
+    uint32_t data32 = rec.data_bytes > 0xFFFFFFFFu ? 0xFFFFFFFFu : (uint32_t)rec.data_bytes;
+
+    ChannelMap_t map;
+    memset(&map, 0, sizeof(map));
+    map.channels = ch > OD_MAX_CHANNELS ? OD_MAX_CHANNELS : ch;
+    memcpy(map.position, rec.position, sizeof(map.position));
+
+    static const uint8_t float_guid[16] = {
+        0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0x10, 0x00, 0x80, 0x00, 0x00, 0xaa, 0x00, 0x38, 0x9b, 0x71
+    };
+    memcpy(h, "RIFF", 4);
+    put32le(h + 4, riff32);
+    memcpy(h + 8, "WAVEfmt ", 8);
+    put32le(h + 16, 40);
+    put16le(h + 20, 0xFFFE);
+    put16le(h + 22, ch);
+    put32le(h + 24, rate);
+    put32le(h + 28, rate * 4 * ch);
+    put16le(h + 32, 4 * ch);
+    put16le(h + 34, 32);
+    put16le(h + 36, 22);
+    put16le(h + 38, 32);
+    put32le(h + 40, od_channel_map_to_wave_mask(&map));
+    memcpy(h + 44, float_guid, 16);
+    memcpy(h + 60, "data", 4);
+    put32le(h + 64, data32);
+}
+
+/* ──────────────────── Writer thread ──────────────────── */
+
+static double now_seconds(void) {
+#ifdef _WIN32
+    return (double)GetTickCount64() * 1e-3;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+#endif
+}
+
+static void sleep_ms(unsigned int ms) {
+#ifdef _WIN32
+    Sleep(ms);
+#else
+    struct timespec ts = { 0, (long)ms * 1000000L };
+    nanosleep(&ts, NULL);
+#endif
+}
+
+/* Makes sure `bytes` past the current end of the data are mapped. */
+static int reserve(uint64_t bytes) {
+    uint64_t needed = rec.header_bytes + rec.data_bytes + bytes;
+    if (needed <= rec.mapped) return 1;
+    uint64_t grown = (needed + SEGMENT_BYTES - 1) / SEGMENT_BYTES * SEGMENT_BYTES;
+    return map_resize(grown);
+}
+
+/* Encodes the staged frames as one ODLC block at the end of the data. */
+static int encode_staged(void) {
+    uint32_t ch = atomic_load_explicit(&rec.channels, memory_order_relaxed);
+    if (rec.staged_frames == 0) return 1;
+    if (!reserve(od_lossless_max_block_bytes(rec.staged_frames, ch))) return 0;
+
+    if (rec.index_count == rec.index_capacity) {
+        uint32_t capacity = rec.index_capacity ? rec.index_capacity * 2 : 1024;
+        uint64_t* grown = (uint64_t*)realloc(rec.index, (size_t)capacity * sizeof(uint64_t));
+        if (!grown) return 0;
+        rec.index = grown;
+        rec.index_capacity = capacity;
+    }
+
+    uint64_t offset = rec.header_bytes + rec.data_bytes;
+    size_t bytes = od_lossless_encode_block(rec.staging, rec.staged_frames, ch, rec.map + offset);
+    rec.index[rec.index_count++] = offset;
+    rec.data_bytes += bytes;
+    rec.encoded_frames += rec.staged_frames;
+    rec.staged_frames = 0;
+    return 1;
+}
+
+/* Appends `count` interleaved samples to the file: copied straight into
+ * the mapping for WAV/CAF, staged into blocks and encoded for ODLC. */
+static int store(const float* samples, uint64_t count, uint32_t ch) {
+    if (rec.container != CONTAINER_ODLC) {
+        uint64_t bytes = count * sizeof(float);
+        if (!reserve(bytes)) return 0;
+        memcpy(rec.map + rec.header_bytes + rec.data_bytes, samples, (size_t)bytes);
+        rec.data_bytes += bytes;
+        return 1;
+    }
+
+    if (ch > OD_MAX_CHANNELS) return 0;
+    uint64_t block = (uint64_t)OD_LOSSLESS_BLOCK_FRAMES * ch;
+    while (count > 0) {
+        uint64_t staged = (uint64_t)rec.staged_frames * ch + rec.staged_extra;
+        uint64_t n = block - staged;
+        if (n > count) n = count;
+        memcpy(rec.staging + staged, samples, (size_t)n * sizeof(float));
+        rec.staged_frames = (uint32_t)((staged + n) / ch);
+        rec.staged_extra = (uint32_t)((staged + n) % ch);
+        samples += n;
+        count -= n;
+        if (rec.staged_frames == OD_LOSSLESS_BLOCK_FRAMES && !encode_staged()) return 0;
+    }
+    return 1;
+}
+
+/* Moves the whole frames currently in the ring into the file.  A frame
+ * the ring wrap splits reaches store() in two calls, which stages its
+ * first part until the rest arrives.  Returns 0 on an I/O failure, after
+ * which the recording stops. */
+static int drain(void) {
+    uint32_t ch = atomic_load_explicit(&rec.channels, memory_order_acquire);
+    uint64_t tail = atomic_load_explicit(&rec.tail, memory_order_relaxed);
+    uint64_t head = atomic_load_explicit(&rec.head, memory_order_acquire);
+    if (ch == 0) return 1;
+    uint64_t count = (head - tail) / ch * ch;
+    if (count == 0) return 1;
+
+    uint32_t start = (uint32_t)(tail & (RING_FLOATS - 1));
+    uint64_t first = RING_FLOATS - start;
+    if (first > count) first = count;
+    if (!store(rec.ring + start, first, ch) || !store(rec.ring, count - first, ch)) return 0;
+
+    atomic_store_explicit(&rec.tail, tail + count, memory_order_release);
+    uint64_t frames = rec.container == CONTAINER_ODLC
+        ? rec.encoded_frames + rec.staged_frames
+        : rec.data_bytes / (sizeof(float) * ch);
+    atomic_store_explicit(&rec.frames_written, frames, memory_order_relaxed);
+    return 1;
+}
+
+/* ODLC only: encodes the final partial block and appends the index. */
+static int finish_odlc(void) {
+    if (!encode_staged()) return 0;
+    uint64_t bytes = 8 + (uint64_t)rec.index_count * 8;
+    if (!reserve(bytes)) return 0;
+
+    uint8_t* p = rec.map + rec.header_bytes + rec.data_bytes;
+    memcpy(p, OD_LOSSLESS_INDEX_MAGIC, 4);
+    put32le(p + 4, rec.index_count);
+    for (uint32_t i = 0; i < rec.index_count; i++) {
+        put32le(p + 8 + 8 * i, (uint32_t)rec.index[i]);
+        put32le(p + 12 + 8 * i, (uint32_t)(rec.index[i] >> 32));
+    }
+    rec.index_offset = rec.header_bytes + rec.data_bytes;
+    rec.trailer_bytes = bytes;
+    return 1;
+}
+
+static void* writer_main(void* arg) {
+    (void)arg;
+    double last_fixup = now_seconds();
+    uint32_t reported_overruns = 0;
+    int opened = 0;
+
+    for (;;) {
+        int stopping = atomic_load_explicit(&rec.stop, memory_order_acquire);
+
+        if (!opened && atomic_load_explicit(&rec.channels, memory_order_acquire) != 0) {
+            if (!file_open()) {
+                printf("[Recorder] Cannot create %s, recording disabled\n", rec.path);
+                atomic_store(&rec.active, 0);
+                break;
+            }
+            opened = 1;
+            write_header();
+            printf("[Recorder] Writing %u ch @ %u Hz to %s\n",
+                   atomic_load(&rec.channels), atomic_load(&rec.sample_rate), rec.path);
+            fflush(stdout);
+        }
+
+        if (opened) {
+            uint64_t before = rec.data_bytes;
+            if (!drain()) {
+                printf("[Recorder] Write to %s failed, recording stopped\n", rec.path);
+                atomic_store(&rec.active, 0);
+                break;
+            }
+
+            double now = now_seconds();
+            if (now - last_fixup >= FIXUP_SECONDS) {
+                write_header();
+                last_fixup = now;
+
+                uint32_t overruns = atomic_load_explicit(&rec.overruns, memory_order_relaxed);
+                if (overruns != reported_overruns) {
+                    printf("[Recorder] Overrun: %u blocks dropped so far\n", overruns);
+                    fflush(stdout);
+                    reported_overruns = overruns;
+                }
+            }
+            if (rec.data_bytes != before) continue;
+        }
+
+        if (stopping) break;
+        sleep_ms(IDLE_SLEEP_MS);
+    }
+
+    if (opened) {
+        if (rec.container == CONTAINER_ODLC && !finish_odlc()) {
+            printf("[Recorder] Could not finalise %s; it will be replayed by scanning\n", rec.path);
+        }
+        write_header();
+        file_close();
+    }
+    return NULL;
+}
+
+/* ──────────────────── Control ──────────────────── */
+
+int OD_Recorder_Start(const char* path) {
+    if (!path || !*path || atomic_load(&rec.active)) return 0;
+    if (strlen(path) >= sizeof(rec.path)) return 0;
+
+    size_t len = strlen(path);
+    Container_t container = CONTAINER_WAV;
+    if (len > 4 && strcmp(path + len - 4, ".caf") == 0) container = CONTAINER_CAF;
+    else if (len > 5 && strcmp(path + len - 5, ".odlc") == 0) container = CONTAINER_ODLC;
+
+    float* ring = (float*)malloc((size_t)RING_FLOATS * sizeof(float));
+    float* staging = container == CONTAINER_ODLC
+        ? (float*)malloc((size_t)OD_LOSSLESS_BLOCK_FRAMES * OD_MAX_CHANNELS * sizeof(float))
+        : NULL;
+    if (!ring || (container == CONTAINER_ODLC && !staging)) {
+        free(ring);
+        free(staging);
+        return 0;
+    }
+
+    free(rec.ring);
+    memset(&rec, 0, sizeof(rec));
+    rec.ring = ring;
+    rec.staging = staging;
+    rec.container = container;
+    rec.header_bytes = container == CONTAINER_ODLC ? OD_LOSSLESS_HEADER_BYTES : PCM_HEADER_BYTES;
+#ifdef _WIN32
+    rec.file = INVALID_HANDLE_VALUE;
+#else
+    rec.fd = -1;
+#endif
+    strcpy(rec.path, path);
+
+    if (pthread_create(&rec.writer, NULL, writer_main, NULL) != 0) {
+        free(rec.ring);
+        free(rec.staging);
+        rec.ring = NULL;
+        rec.staging = NULL;
+        return 0;
+    }
+    atomic_store_explicit(&rec.active, 1, memory_order_release);
+    static const char* const container_names[] = { "WAV", "CAF", "ODLC" };
+    printf("[Recorder] Armed: %s (%s)\n", path, container_names[rec.container]);
+    fflush(stdout);
+    return 1;
+}
+
+void OD_Recorder_Stop(void) {
+    if (!rec.ring) return;
+
+    /* Stop feeding, wait for a block already being copied, then let the
+     * writer do its final drain. */
+    atomic_store_explicit(&rec.active, 0, memory_order_release);
+    while (atomic_load_explicit(&rec.feeding, memory_order_acquire) != 0) sleep_ms(1);
+    atomic_store_explicit(&rec.stop, 1, memory_order_release);
+    pthread_join(rec.writer, NULL);
+
+    RecorderStats_t stats;
+    OD_Recorder_GetStats(&stats);
+    printf("[Recorder] Stopped: %llu frames written, %llu dropped (%u overruns, %u format changes)\n",
+           (unsigned long long)stats.frames_written, (unsigned long long)stats.frames_dropped,
+           stats.overruns, stats.format_changes);
+    fflush(stdout);
+
+    free(rec.ring);
+    free(rec.staging);
+    free(rec.index);
+    rec.ring = NULL;
+    rec.staging = NULL;
+    rec.index = NULL;
+}
+
+int OD_Recorder_IsActive(void) {
+    return atomic_load_explicit(&rec.active, memory_order_acquire);
+}
+
+void OD_Recorder_GetStats(RecorderStats_t* stats) {
+    if (!stats) return;
+    stats->frames_written = atomic_load_explicit(&rec.frames_written, memory_order_relaxed);
+    stats->frames_dropped = atomic_load_explicit(&rec.frames_dropped, memory_order_relaxed);
+    stats->overruns = atomic_load_explicit(&rec.overruns, memory_order_relaxed);
+    stats->format_changes = atomic_load_explicit(&rec.format_changes, memory_order_relaxed);
+    stats->channels = atomic_load_explicit(&rec.channels, memory_order_relaxed);
+    stats->sample_rate = atomic_load_explicit(&rec.sample_rate, memory_order_relaxed);
+}
@@ -0,0 +1,45 @@
+#ifndef OD_RECORDER_H
+#define OD_RECORDER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "../../include/od_export.h"
+#include <stdint.h>
+
+/* Records exactly what the capture backend delivered, as float32, to a
+ * WAV (WAVE_FORMAT_EXTENSIBLE) or, for paths ending in ".caf", a CAF file.
+ * Paths ending in ".odlc" are compressed losslessly (see lossless.h); the
+ * encoding runs on the writer thread, never on the audio thread.
+ *
+ * The audio thread only copies each block into a lock-free SPSC ring;
+ * when the ring is full the block is dropped and counted as an overrun.
+ * A background writer drains the ring into a preallocated, memory-mapped
+ * file, growing it in large segments and rewriting the header sizes
+ * periodically so a crash still leaves a playable file. */
+
+typedef struct {
+    uint64_t frames_written;
+    uint64_t frames_dropped;
+    uint32_t overruns;          /* blocks dropped because the ring was full */
+    uint32_t format_changes;    /* blocks dropped because channels/rate differed */
+    uint32_t channels;          /* 0 until the first block arrived */
+    uint32_t sample_rate;
+} RecorderStats_t;
+
+OD_API int  OD_Recorder_Start(const char* path);
+OD_API void OD_Recorder_Stop(void);
+OD_API int  OD_Recorder_IsActive(void);
+OD_API void OD_Recorder_GetStats(RecorderStats_t* stats);
+
+/* Called by capture backends from their audio thread with every block.
+ * Wait-free: no locks, no allocation, no system calls. */
+void od_recorder_feed(const float* samples, uint32_t frames, uint32_t channels,
+                      uint32_t sample_rate, const uint8_t* position);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
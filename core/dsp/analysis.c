@@ -0,0 +1,134 @@
+#include "analysis.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <string.h>
+
+#define WAIT_MS     2       /* upper bound for pull backends, which never signal */
+#define FRESH       4u      /* flag on triple.middle: written since the reader last swapped */
+
+static struct {
+    /* ── Control ── */
+    pthread_t thread;
+    atomic_int running;
+    atomic_int stop;
+    DSPContext_t* ctx;
+    _Atomic float sensitivity;
+    _Atomic float separation;
+
+    /* ── Triple buffer: writer owns `back`, reader owns `front`, and the
+     *    two trade slots through `middle` with one atomic exchange ── */
+    SpatialData_t slot[3];
+    unsigned back;
+    unsigned front;
+    atomic_uint middle;
+
+    /* ── Stats ── */
+    _Atomic uint64_t processed;
+    _Atomic uint64_t missed;
+    _Atomic uint64_t gated;
+    atomic_uint last_sequence;
+} analysis;
+
+static void publish(const SpatialData_t* result) {
+    analysis.slot[analysis.back] = *result;
+    unsigned previous = atomic_exchange_explicit(&analysis.middle, analysis.back | FRESH, memory_order_acq_rel);
+    analysis.back = previous & 3u;
+}
+
+static void* analysis_main(void* arg) {
+    (void)arg;
+    uint32_t seen = 0;
+    int have_seen = 0;
+
+    while (!atomic_load_explicit(&analysis.stop, memory_order_acquire)) {
+        AudioBuffer_t* buffer = OD_Capture_GetLatestBuffer();
+        if (!buffer || !buffer->buffer || (have_seen && buffer->sequence == seen)) {
+            OD_Capture_WaitForBlock(have_seen ? seen : 0, WAIT_MS);
+            continue;
+        }
+
+        if (have_seen && buffer->sequence - seen > 1) {
+            atomic_fetch_add_explicit(&analysis.missed, buffer->sequence - seen - 1, memory_order_relaxed);
+        }
+        seen = buffer->sequence;
+        have_seen = 1;
+        atomic_store_explicit(&analysis.last_sequence, seen, memory_order_relaxed);
+
+        if (buffer->gated) atomic_fetch_add_explicit(&analysis.gated, 1, memory_order_relaxed);
+        SpatialData_t result = OD_DSP_Process(analysis.ctx, buffer,
+                                              atomic_load_explicit(&analysis.sensitivity, memory_order_relaxed),
+                                              atomic_load_explicit(&analysis.separation, memory_order_relaxed));
+        publish(&result);
+        atomic_fetch_add_explicit(&analysis.processed, 1, memory_order_relaxed);
+    }
+    return NULL;
+}
+
+int OD_Analysis_Start(DSPContext_t* ctx, float sensitivity, float separation) {
+    if (!ctx || atomic_load(&analysis.running)) return 0;
+
+    memset(analysis.slot, 0, sizeof(analysis.slot));
+    analysis.back = 0;
+    analysis.front = 1;
+    atomic_store(&analysis.middle, 2u);
+    atomic_store(&analysis.processed, 0);
+    atomic_store(&analysis.missed, 0);
+    atomic_store(&analysis.gated, 0);
+    atomic_store(&analysis.last_sequence, 0);
+    atomic_store(&analysis.stop, 0);
+    analysis.ctx = ctx;
+    OD_Analysis_SetParams(sensitivity, separation);
+
+    if (pthread_create(&analysis.thread, NULL, analysis_main, NULL) != 0) {
+        printf("[Analysis] Could not start the analysis thread\n");
+        return 0;
+    }
+    atomic_store(&analysis.running, 1);
+    printf("[Analysis] Thread started\n");
+    fflush(stdout);
+    return 1;
+}
+
+void OD_Analysis_Stop(void) {
+    if (!atomic_load(&analysis.running)) return;
+    atomic_store_explicit(&analysis.stop, 1, memory_order_release);
+    pthread_join(analysis.thread, NULL);
+    atomic_store(&analysis.running, 0);
+
+    AnalysisStats_t stats;
+    OD_Analysis_GetStats(&stats);
+    printf("[Analysis] Stopped: %llu blocks analysed, %llu missed, %llu gated\n",
+           (unsigned long long)stats.blocks_processed, (unsigned long long)stats.blocks_missed,
+           (unsigned long long)stats.blocks_gated);
+    fflush(stdout);
+}
+
+int OD_Analysis_IsRunning(void) {
+    return atomic_load(&analysis.running);
+}
+
+void OD_Analysis_SetParams(float sensitivity, float separation) {
+    atomic_store_explicit(&analysis.sensitivity, sensitivity, memory_order_relaxed);
+    atomic_store_explicit(&analysis.separation, separation, memory_order_relaxed);
+}
+
+int OD_Analysis_GetLatest(SpatialData_t* out) {
+    if (!out) return 0;
+    int fresh = 0;
+    if (atomic_load_explicit(&analysis.middle, memory_order_acquire) & FRESH) {
+        unsigned previous = atomic_exchange_explicit(&analysis.middle, analysis.front, memory_order_acq_rel);
+        analysis.front = previous & 3u;
+        fresh = 1;
+    }
+    *out = analysis.slot[analysis.front];
+    return fresh;
+}
+
+void OD_Analysis_GetStats(AnalysisStats_t* stats) {
+    if (!stats) return;
+    stats->blocks_processed = atomic_load_explicit(&analysis.processed, memory_order_relaxed);
+    stats->blocks_missed = atomic_load_explicit(&analysis.missed, memory_order_relaxed);
+    stats->blocks_gated = atomic_load_explicit(&analysis.gated, memory_order_relaxed);
+    stats->last_sequence = atomic_load_explicit(&analysis.last_sequence, memory_order_relaxed);
+}
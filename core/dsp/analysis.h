@@ -0,0 +1,47 @@
+#ifndef OD_ANALYSIS_H
+#define OD_ANALYSIS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "../../include/od_export.h"
+#ifdef _WIN32
+#include "dsp_windows.h"
+#else
+#include "dsp.h"
+#endif
+
+/* Engine-owned analysis thread.
+ *
+ * Pulls every block from the active capture backend as it is published
+ * (woken by the backend, not by the display) and runs OD_DSP_Process on
+ * it.  Results go through a lock-free triple buffer, so the renderer
+ * reads the newest SpatialData_t without ever waiting on the DSP, and the
+ * DSP never waits on a slow swap.
+ *
+ * While running, the thread is the only caller of
+ * OD_Capture_GetLatestBuffer and of OD_DSP_Process on `ctx`. */
+
+typedef struct {
+    uint64_t blocks_processed;
+    uint64_t blocks_missed;         /* published but overwritten before the thread got to them */
+    uint64_t blocks_gated;          /* skipped by the silence gate */
+    uint32_t last_sequence;
+} AnalysisStats_t;
+
+OD_API int  OD_Analysis_Start(DSPContext_t* ctx, float sensitivity, float separation);
+OD_API void OD_Analysis_Stop(void);
+OD_API int  OD_Analysis_IsRunning(void);
+OD_API void OD_Analysis_SetParams(float sensitivity, float separation);
+
+/* Copies the newest result into `out`.  Returns 1 if it is newer than the
+ * one returned by the previous call.  Single reader. */
+OD_API int  OD_Analysis_GetLatest(SpatialData_t* out);
+OD_API void OD_Analysis_GetStats(AnalysisStats_t* stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
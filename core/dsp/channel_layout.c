@@ -0,0 +1,207 @@
+#include "channel_layout.h"
+#include <math.h>
+#include <string.h>
+
+#define PI 3.14159265358979323846f
+
+/* ──────────────────── Position geometry ────────────────────
+ *
+ *  Angles follow the original 7.1 table (FL/FR at ±45°, sides at
+ *  ±90°, backs at ±135°); height speakers sit 45° up.
+ *  Azimuth < 0 marks a non-directional position.
+ */
+
+typedef struct {
+    const char* name;
+    float azimuth;
+    float elevation;
+} PositionInfo_t;
+
+static const PositionInfo_t position_info[CH_POS_COUNT] = {
+    [CH_POS_UNKNOWN] = { "UNK",  -1.0f,  0.0f },
+    [CH_POS_MONO]    = { "MONO",  0.0f,  0.0f },
+    [CH_POS_FL]      = { "FL",  315.0f,  0.0f },
+    [CH_POS_FR]      = { "FR",   45.0f,  0.0f },
+    [CH_POS_FC]      = { "FC",    0.0f,  0.0f },
+    [CH_POS_LFE]     = { "LFE",  -1.0f,  0.0f },
+    [CH_POS_BL]      = { "BL",  225.0f,  0.0f },
+    [CH_POS_BR]      = { "BR",  135.0f,  0.0f },
+    [CH_POS_SL]      = { "SL",  270.0f,  0.0f },
+    [CH_POS_SR]      = { "SR",   90.0f,  0.0f },
+    [CH_POS_FLC]     = { "FLC", 337.5f,  0.0f },
+    [CH_POS_FRC]     = { "FRC",  22.5f,  0.0f },
+    [CH_POS_BC]      = { "BC",  180.0f,  0.0f },
+    [CH_POS_FLW]     = { "FLW", 300.0f,  0.0f },
+    [CH_POS_FRW]     = { "FRW",  60.0f,  0.0f },
+    [CH_POS_TFL]     = { "TFL", 315.0f, 45.0f },
+    [CH_POS_TFR]     = { "TFR",  45.0f, 45.0f },
+    [CH_POS_TFC]     = { "TFC",   0.0f, 45.0f },
+    [CH_POS_TC]      = { "TC",    0.0f, 90.0f },
+    [CH_POS_TBL]     = { "TBL", 225.0f, 45.0f },
+    [CH_POS_TBR]     = { "TBR", 135.0f, 45.0f },
+    [CH_POS_TSL]     = { "TSL", 270.0f, 45.0f },
+    [CH_POS_TSR]     = { "TSR",  90.0f, 45.0f },
+    [CH_POS_TBC]     = { "TBC", 180.0f, 45.0f },
+    [CH_POS_LFE2]    = { "LFE2", -1.0f,  0.0f },
+};
+
+const char* od_channel_position_name(uint32_t position) {
+    if (position < CH_POS_COUNT) return position_info[position].name;
+    return "UNK";
+}
+
+/* ──────────────────── Standard maps ──────────────────── */
+
+static const uint8_t map_71[8] = {
+    CH_POS_FL, CH_POS_FR, CH_POS_FC, CH_POS_LFE, CH_POS_BL, CH_POS_BR, CH_POS_SL, CH_POS_SR
+};
+
+void od_channel_map_default(uint32_t channels, ChannelMap_t* map) {
+    memset(map, 0, sizeof(ChannelMap_t));
+    if (channels > OD_MAX_CHANNELS) channels = OD_MAX_CHANNELS;
+    map->channels = channels;
+    uint8_t* p = map->position;
+
+    switch (channels) {
+        case 0: return;
+        case 1: p[0] = CH_POS_MONO; return;
+        case 2: p[0] = CH_POS_FL; p[1] = CH_POS_FR; return;
+        case 3: p[0] = CH_POS_FL; p[1] = CH_POS_FR; p[2] = CH_POS_LFE; return;
+        case 4: p[0] = CH_POS_FL; p[1] = CH_POS_FR; p[2] = CH_POS_BL; p[3] = CH_POS_BR; return;
+        case 5: p[0] = CH_POS_FL; p[1] = CH_POS_FR; p[2] = CH_POS_FC; p[3] = CH_POS_BL; p[4] = CH_POS_BR; return;
+        case 6: memcpy(p, map_71, 6); return;
+        case 7:
+            memcpy(p, map_71, 4);
+            p[4] = CH_POS_BC; p[5] = CH_POS_SL; p[6] = CH_POS_SR;
+            return;
+        default:
+            break;
+    }
+
+    /* 8 channels and up start from 7.1 and add wides/heights. */
+    memcpy(p, map_71, 8);
+    switch (channels) {
+        case 10: /* 7.1.2 */
+            p[8] = CH_POS_TSL; p[9] = CH_POS_TSR;
+            break;
+        case 12: /* 7.1.4 */
+            p[8] = CH_POS_TFL; p[9] = CH_POS_TFR; p[10] = CH_POS_TBL; p[11] = CH_POS_TBR;
+            break;
+        case 14: /* 9.1.4 */
+            p[8] = CH_POS_FLW; p[9] = CH_POS_FRW;
+            p[10] = CH_POS_TFL; p[11] = CH_POS_TFR; p[12] = CH_POS_TBL; p[13] = CH_POS_TBR;
+            break;
+        case 16: /* 9.1.6 */
+            p[8] = CH_POS_FLW; p[9] = CH_POS_FRW;
+            p[10] = CH_POS_TFL; p[11] = CH_POS_TFR; p[12] = CH_POS_TSL; p[13] = CH_POS_TSR;
+            p[14] = CH_POS_TBL; p[15] = CH_POS_TBR;
+            break;
+        default:
+            break;  /* extra channels stay CH_POS_UNKNOWN */
+    }
+}
+
+int od_channel_map_equal(const ChannelMap_t* a, const ChannelMap_t* b) {
+    return a->channels == b->channels &&
+           memcmp(a->position, b->position, a->channels) == 0;
+}
+
+/* SPEAKER_* bits of a WAVE_FORMAT_EXTENSIBLE dwChannelMask, lowest first;
+ * interleaved channels follow the set bits in that order. */
+static const uint8_t wave_mask_positions[18] = {
+    CH_POS_FL, CH_POS_FR, CH_POS_FC, CH_POS_LFE, CH_POS_BL, CH_POS_BR,
+    CH_POS_FLC, CH_POS_FRC, CH_POS_BC, CH_POS_SL, CH_POS_SR, CH_POS_TC,
+    CH_POS_TFL, CH_POS_TFC, CH_POS_TFR, CH_POS_TBL, CH_POS_TBC, CH_POS_TBR
+};
+
+void od_channel_map_from_wave_mask(uint32_t mask, uint32_t channels, ChannelMap_t* map) {
+    memset(map, 0, sizeof(ChannelMap_t));
+    if (channels > OD_MAX_CHANNELS) channels = OD_MAX_CHANNELS;
+    map->channels = channels;
+
+    uint32_t c = 0;
+    for (uint32_t bit = 0; bit < 18 && c < channels; bit++) {
+        if (mask & (1u << bit)) map->position[c++] = wave_mask_positions[bit];
+    }
+}
+
+uint32_t od_channel_map_to_wave_mask(const ChannelMap_t* map) {
+    uint32_t mask = 0;
+    int last = -1;
+    for (uint32_t c = 0; c < map->channels; c++) {
+        int bit = -1;
+        for (int b = 0; b < 18; b++) {
+            if (wave_mask_positions[b] == map->position[c]) { bit = b; break; }
+        }
+        /* WAV orders channels by ascending bit; anything else is unrepresentable. */
+        if (bit <= last) return 0;
+        mask |= 1u << bit;
+        last = bit;
+    }
+    return mask;
+}
+
+/* ──────────────────── Geometry ──────────────────── */
+
+void od_channel_geometry_build(const ChannelMap_t* map, ChannelGeometry_t* geom) {
+    memset(geom, 0, sizeof(ChannelGeometry_t));
+
+    /* Otherwise nothing is directional and the L/R downmix stays silent. */
+    ChannelMap_t standard;
+    int positioned = 0;
+    for (uint32_t c = 0; c < map->channels && c < OD_MAX_CHANNELS; c++) {
+        if (map->position[c] != CH_POS_UNKNOWN && map->position[c] < CH_POS_COUNT) positioned = 1;
+    }
+    if (!positioned) {
+        od_channel_map_default(map->channels, &standard);
+        map = &standard;
+    }
+    geom->channels = map->channels > OD_MAX_CHANNELS ? OD_MAX_CHANNELS : map->channels;
+
+    int rear_or_side = 0;
+    for (uint32_t c = 0; c < geom->channels; c++) {
+        uint32_t pos = map->position[c];
+        const PositionInfo_t* info = &position_info[pos < CH_POS_COUNT ? pos : CH_POS_UNKNOWN];
+
+        geom->azimuth[c] = info->azimuth;
+        geom->elevation[c] = info->elevation;
+        if (info->azimuth < 0.0f) continue;
+
+        float az = info->azimuth * PI / 180.0f;
+        float el = info->elevation * PI / 180.0f;
+        geom->vec_x[c] = cosf(el) * sinf(az);
+        geom->vec_y[c] = cosf(el) * cosf(az);
+        geom->vec_z[c] = sinf(el);
+        geom->dir_index[geom->dir_count++] = (uint8_t)c;
+
+        if (info->elevation > 0.0f) geom->has_height = 1;
+        if (info->azimuth > 67.5f && info->azimuth < 292.5f) rear_or_side = 1;
+    }
+
+    /* Front-only layouts (mono, 2.0, 3.0, ...) cannot be localised by
+     * vector summation; they keep the left/right pan model. */
+    geom->pans = !rear_or_side && !geom->has_height;
+
+    for (uint32_t c = 0; c < geom->channels; c++) {
+        uint32_t pos = map->position[c];
+        if (geom->azimuth[c] < 0.0f) continue;
+
+        if (geom->pans) {
+            if (pos == CH_POS_MONO) { geom->mix_l[c] = 1.0f; geom->mix_r[c] = 1.0f; }
+            else if (geom->vec_x[c] < -0.15f) geom->mix_l[c] = 1.0f;
+            else if (geom->vec_x[c] > 0.15f) geom->mix_r[c] = 1.0f;
+            else { geom->mix_l[c] = 0.707f; geom->mix_r[c] = 0.707f; }
+            continue;
+        }
+
+        /* negative sin → left contribution, positive sin → right;
+         * center (sin≈0) contributes equally */
+        float lr_weight = sinf(geom->azimuth[c] * PI / 180.0f);
+        if (lr_weight < 0.0f) geom->mix_l[c] = -lr_weight;
+        else geom->mix_r[c] = lr_weight;
+        if (fabsf(lr_weight) < 0.15f) {
+            geom->mix_l[c] += 0.707f;
+            geom->mix_r[c] += 0.707f;
+        }
+    }
+}
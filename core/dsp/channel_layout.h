@@ -0,0 +1,49 @@
+#ifndef OD_CHANNEL_LAYOUT_H
+#define OD_CHANNEL_LAYOUT_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "dsp_config.h"
+
+/* Per-context tables derived from a ChannelMap_t.  Directional channels
+ * are listed in dir_index[]; everything else (LFE, unknown) is ignored by
+ * the localiser.  Azimuth: 0° ahead, clockwise positive.  Elevation:
+ * 0° ear level, +90° straight up.  Unit vectors: x right, y ahead, z up. */
+
+typedef struct {
+    uint32_t channels;
+    uint32_t dir_count;
+    uint8_t dir_index[OD_MAX_CHANNELS];     /* interleaved index of each directional channel */
+    float azimuth[OD_MAX_CHANNELS];         /* per interleaved channel, -1 = non-directional */
+    float elevation[OD_MAX_CHANNELS];
+    float vec_x[OD_MAX_CHANNELS];
+    float vec_y[OD_MAX_CHANNELS];
+    float vec_z[OD_MAX_CHANNELS];
+    float mix_l[OD_MAX_CHANNELS];           /* classifier downmix matrix */
+    float mix_r[OD_MAX_CHANNELS];
+    int pans;                               /* front-only layout: localise by L/R pan */
+    int has_height;
+} ChannelGeometry_t;
+
+/* Standard map for a channel count (2.0, 5.1, 7.1, 7.1.4, 9.1.6, ...). */
+void od_channel_map_default(uint32_t channels, ChannelMap_t* map);
+int  od_channel_map_equal(const ChannelMap_t* a, const ChannelMap_t* b);
+const char* od_channel_position_name(uint32_t position);
+
+/* Positions from a WAVEFORMATEXTENSIBLE dwChannelMask; channels beyond
+ * the mask's set bits stay CH_POS_UNKNOWN. */
+void od_channel_map_from_wave_mask(uint32_t mask, uint32_t channels, ChannelMap_t* map);
+/* Inverse; 0 when the map has positions WAV cannot express or in a non-WAV order. */
+uint32_t od_channel_map_to_wave_mask(const ChannelMap_t* map);
+
+/* A map with no known position at all (an unpositioned stream, a raw
+ * file) is built as the standard map for its channel count. */
+void od_channel_geometry_build(const ChannelMap_t* map, ChannelGeometry_t* geom);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
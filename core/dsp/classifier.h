@@ -38,6 +38,20 @@ typedef struct {
     float zero_crossing_rate; 
 } SpectralFeatures_t;
 
+/* Scoring calls since OD_Classifier_Init.  The DSP scores each analysed
+ * frame once and then each entity it separates, so `calls` is not a
+ * frame count. */
+typedef struct {
+    uint64_t calls;
+    uint64_t gated;                 /* calls below the active preset's or model's min_energy: no rule or layer ran */
+} ClassifierStats_t;
+
+/* MFCC frame features: OD_MFCC_COEFFS cepstral coefficients of the
+ * log-mel spectrum, then their deltas, then the delta-deltas. */
+#define OD_MFCC_BANDS       32
+#define OD_MFCC_COEFFS      13
+#define OD_MFCC_FEATURES    (3 * OD_MFCC_COEFFS)
+
 
 typedef struct {
     const char* name;       
@@ -51,15 +65,66 @@ typedef struct {
 void OD_Classifier_Init(void);
 
 
+/* "pubg" (built in), "none", or the path of a preset file (see
+ * classifier_rules.h).  Safe to call while classification is running. */
 void OD_Classifier_SetPreset(const char* preset_name);
 
+/* Compiles the preset file at `path` and makes it active.  On error the
+ * current preset is kept and 0 is returned. */
+int OD_Classifier_LoadPreset(const char* path);
+
+/* Maps a trained model (see classifier_model.h) and classifies with it
+ * instead of the preset rules; NULL or "" goes back to the rules.  On
+ * error the current model is kept and 0 is returned. */
+int OD_Classifier_LoadModel(const char* path);
+
 
 SpectralFeatures_t OD_Classifier_ExtractFeatures(const float* left, const float* right,
                                                    uint32_t num_samples, uint32_t sample_rate);
 
+/* As above, but the transient is measured against `*prev`, which is then
+ * updated, so every DSP context can keep its own history. */
+SpectralFeatures_t OD_Classifier_ExtractFeaturesFrom(const float* left, const float* right,
+                                                       uint32_t num_samples, uint32_t sample_rate,
+                                                       SpectralFeatures_t* prev);
+
+/* As above, with the band energies, centroid and spread read from
+ * `power`, the |X[k]|^2 / n spectrum (k = 0..fft_size/2) of the mono
+ * downmix the caller already has, instead of transforming again. */
+SpectralFeatures_t OD_Classifier_FeaturesFromSpectrum(const float* left, const float* right, uint32_t num_samples,
+                                                        const float* power, uint32_t fft_size, uint32_t sample_rate,
+                                                        SpectralFeatures_t* prev);
+
+/* Features of one spectral region: power[i] is |X[k]|^2 / n at bin
+ * k = bins[i] of an fft_size transform of num_samples samples.  Energy,
+ * band ratios and zero-crossing rate are all estimated from those bins
+ * alone, so the cost follows the region's size. */
+SpectralFeatures_t OD_Classifier_FeaturesFromBins(const float* power, const uint16_t* bins, uint32_t count,
+                                                   uint32_t num_samples, uint32_t fft_size, uint32_t sample_rate,
+                                                   SpectralFeatures_t* prev);
+
 
 ClassResult_t OD_Classifier_Classify(const SpectralFeatures_t* features);
 
+/* As above, also passing the frame's OD_MFCC_FEATURES MFCC vector (may be
+ * NULL) for models that take it. */
+ClassResult_t OD_Classifier_ClassifyFrame(const SpectralFeatures_t* features, const float* mfcc);
+
+/* As above, also filling scores[SOUND_TYPE_COUNT] (may be NULL) with every
+ * type's score on the active preset's or model's own scale.  Unknown gets
+ * the bar the winner has to clear, so, ties aside, the result is the type
+ * with the best score. */
+ClassResult_t OD_Classifier_ScoreFrame(const SpectralFeatures_t* features, const float* mfcc, float* scores);
+
+void OD_Classifier_GetStats(ClassifierStats_t* stats);
+
+/* Whether the active model reads MFCCs, so callers can skip computing them. */
+int OD_Classifier_WantsMFCC(void);
+
+/* Whether it reads them for a frame with these features: the energy gate
+ * runs first, so a frame below it is rejected without its MFCCs. */
+int OD_Classifier_NeedsMFCC(const SpectralFeatures_t* features);
+
 
 const char* OD_Classifier_TypeName(SoundType_t type);
 
@@ -0,0 +1,355 @@
+#include "classifier_model.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define OD_MODEL_SSE2 1
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define OD_MODEL_NEON 1
+#endif
+
+#define HEADER_BYTES 32
+#define ALIGN16(x) (((x) + 15u) & ~(size_t)15u)
+
+typedef struct {
+    uint32_t in, out, stride;
+    uint32_t activation;
+    const float* bias;
+    const float* scale;
+    const int8_t* weight;                       /* [out][stride] */
+} Layer_t;
+
+struct ClassifierModel {
+    const uint8_t* map;
+    size_t size;
+#ifdef _WIN32
+    HANDLE file;
+    HANDLE mapping;
+#endif
+
+    uint32_t input_kind;
+    uint32_t inputs;
+    uint32_t outputs;
+    uint32_t layers;
+    float min_energy;
+    float min_confidence;
+    const float* mean;
+    const float* in_scale;
+    const uint8_t* output_type;
+    Layer_t layer[OD_MODEL_MAX_LAYERS];
+};
+
+/* ──────────────────── Loading ──────────────────── */
+
+static uint32_t get_u32(const uint8_t* p) {
+    return (uint32_t)p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24;
+}
+
+static float get_f32(const uint8_t* p) {
+    uint32_t u = get_u32(p);
+    float f;
+    memcpy(&f, &u, sizeof(f));
+    return f;
+}
+
+/* Claims `bytes` at *offset, then moves *offset to the next 16-byte
+ * boundary.  Returns NULL when the file is too short. */
+static const uint8_t* take(const ClassifierModel_t* m, size_t* offset, size_t bytes) {
+    if (*offset > m->size || bytes > m->size - *offset) return NULL;
+    const uint8_t* p = m->map + *offset;
+    *offset = ALIGN16(*offset + bytes);
+    return p;
+}
+
+#define SPECTRAL_INPUTS (sizeof(SpectralFeatures_t) / sizeof(float))
+
+static uint32_t input_count(uint32_t kind) {
+    switch (kind) {
+        case OD_MODEL_INPUT_SPECTRAL:       return SPECTRAL_INPUTS;
+        case OD_MODEL_INPUT_MFCC:           return OD_MFCC_FEATURES;
+        case OD_MODEL_INPUT_SPECTRAL_MFCC:  return SPECTRAL_INPUTS + OD_MFCC_FEATURES;
+        default:                            return 0;
+    }
+}
+
+static const char* parse(ClassifierModel_t* m) {
+    if (m->size < HEADER_BYTES || memcmp(m->map, OD_MODEL_MAGIC, 4) != 0) return "not a model file";
+    if (get_u32(m->map + 4) != OD_MODEL_VERSION) return "unsupported version";
+    m->input_kind = get_u32(m->map + 8);
+    m->inputs = get_u32(m->map + 12);
+    m->layers = get_u32(m->map + 16);
+    m->outputs = get_u32(m->map + 20);
+    m->min_energy = get_f32(m->map + 24);
+    m->min_confidence = get_f32(m->map + 28);
+    if (m->input_kind > OD_MODEL_INPUT_SPECTRAL_MFCC || m->inputs != input_count(m->input_kind))
+        return "unsupported input features";
+    if (m->layers == 0 || m->layers > OD_MODEL_MAX_LAYERS) return "bad layer count";
+    if (m->outputs == 0 || m->outputs > OD_MODEL_MAX_WIDTH) return "bad output count";
+
+    /* Pointers into the mapping stay 16-byte aligned: the map is page
+     * aligned and every section starts on a 16-byte boundary. */
+    size_t offset = HEADER_BYTES;
+    m->mean = (const float*)take(m, &offset, m->inputs * sizeof(float));
+    m->in_scale = (const float*)take(m, &offset, m->inputs * sizeof(float));
+    m->output_type = take(m, &offset, m->outputs);
+    if (!m->mean || !m->in_scale || !m->output_type) return "truncated";
+    for (uint32_t o = 0; o < m->outputs; o++) {
+        if (m->output_type[o] >= SOUND_TYPE_COUNT) return "bad output type";
+    }
+
+    uint32_t width = m->inputs;
+    for (uint32_t l = 0; l < m->layers; l++) {
+        Layer_t* layer = &m->layer[l];
+        const uint8_t* h = take(m, &offset, 16);
+        if (!h) return "truncated";
+        layer->in = get_u32(h);
+        layer->out = get_u32(h + 4);
+        layer->activation = get_u32(h + 8);
+        layer->stride = (uint32_t)ALIGN16(layer->in);
+        if (layer->in != width) return "layer sizes do not chain";
+        if (layer->out == 0 || layer->out > OD_MODEL_MAX_WIDTH) return "layer too wide";
+        if (layer->activation > OD_ACT_SOFTMAX) return "unknown activation";
+        layer->bias = (const float*)take(m, &offset, layer->out * sizeof(float));
+        layer->scale = (const float*)take(m, &offset, layer->out * sizeof(float));
+        layer->weight = (const int8_t*)take(m, &offset, (size_t)layer->out * layer->stride);
+        if (!layer->bias || !layer->scale || !layer->weight) return "truncated";
+        width = layer->out;
+    }
+    if (width != m->outputs) return "last layer does not match the outputs";
+    return NULL;
+}
+
+ClassifierModel_t* od_model_open(const char* path) {
+    if (!path) return NULL;
+    ClassifierModel_t* m = (ClassifierModel_t*)calloc(1, sizeof(ClassifierModel_t));
+    if (!m) return NULL;
+
+#ifdef _WIN32
+    m->file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    LARGE_INTEGER size;
+    if (m->file != INVALID_HANDLE_VALUE && GetFileSizeEx(m->file, &size) && size.QuadPart > 0) {
+        m->mapping = CreateFileMappingA(m->file, NULL, PAGE_READONLY, 0, 0, NULL);
+        m->map = m->mapping ? (const uint8_t*)MapViewOfFile(m->mapping, FILE_MAP_READ, 0, 0, 0) : NULL;
+        m->size = (size_t)size.QuadPart;
+    }
+#else
+    int fd = open(path, O_RDONLY);
+    struct stat st;
+    if (fd >= 0 && fstat(fd, &st) == 0 && st.st_size > 0) {
+        void* p = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p != MAP_FAILED) {
+            m->map = (const uint8_t*)p;
+            m->size = (size_t)st.st_size;
+        }
+    }
+    if (fd >= 0) close(fd);
+#endif
+    if (!m->map) {
+        printf("[Classifier] Cannot map model %s\n", path);
+        od_model_close(m);
+        return NULL;
+    }
+    const char* error = parse(m);
+    if (error) {
+        printf("[Classifier] %s: %s\n", path, error);
+        od_model_close(m);
+        return NULL;
+    }
+    return m;
+}
+
+void od_model_close(ClassifierModel_t* m) {
+    if (!m) return;
+#ifdef _WIN32
+    if (m->map) UnmapViewOfFile(m->map);
+    if (m->mapping) CloseHandle(m->mapping);
+    if (m->file && m->file != INVALID_HANDLE_VALUE) CloseHandle(m->file);
+#else
+    if (m->map) munmap((void*)m->map, m->size);
+#endif
+    free(m);
+}
+
+/* ──────────────────── Inference ──────────────────── */
+
+#if defined(OD_MODEL_SSE2)
+/* Sign-extends 16 int8 weights into four float vectors. */
+static inline void widen_i8(const int8_t* p, __m128* w) {
+    __m128i b = _mm_loadu_si128((const __m128i*)p);
+    __m128i lo = _mm_srai_epi16(_mm_unpacklo_epi8(b, b), 8);
+    __m128i hi = _mm_srai_epi16(_mm_unpackhi_epi8(b, b), 8);
+    w[0] = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(lo, lo), 16));
+    w[1] = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(lo, lo), 16));
+    w[2] = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(hi, hi), 16));
+    w[3] = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(hi, hi), 16));
+}
+
+static inline __m128 dot16(const int8_t* row, const __m128* x, __m128 acc) {
+    __m128 w[4];
+    widen_i8(row, w);
+    acc = _mm_add_ps(acc, _mm_mul_ps(w[0], x[0]));
+    acc = _mm_add_ps(acc, _mm_mul_ps(w[1], x[1]));
+    acc = _mm_add_ps(acc, _mm_mul_ps(w[2], x[2]));
+    return _mm_add_ps(acc, _mm_mul_ps(w[3], x[3]));
+}
+#endif
+
+/* y[r] = sum_i w[r][i] * x[i] for int8 rows of `stride` (a multiple of 16)
+ * against float x, widened in registers and accumulated in float. */
+static void gemv_i8(const int8_t* w, uint32_t rows, uint32_t stride, const float* x, float* y) {
+    uint32_t r = 0;
+#if defined(OD_MODEL_SSE2)
+    /* Four rows at a time share the x loads and reduce to one vector of
+     * results without leaving the registers. */
+    for (; r + 4 <= rows; r += 4) {
+        const int8_t* row = w + (size_t)r * stride;
+        __m128 a0 = _mm_setzero_ps(), a1 = _mm_setzero_ps(), a2 = _mm_setzero_ps(), a3 = _mm_setzero_ps();
+        for (uint32_t i = 0; i < stride; i += 16) {
+            __m128 xv[4] = { _mm_loadu_ps(x + i), _mm_loadu_ps(x + i + 4),
+                             _mm_loadu_ps(x + i + 8), _mm_loadu_ps(x + i + 12) };
+            a0 = dot16(row + i, xv, a0);
+            a1 = dot16(row + stride + i, xv, a1);
+            a2 = dot16(row + 2 * stride + i, xv, a2);
+            a3 = dot16(row + 3 * stride + i, xv, a3);
+        }
+        __m128 u = _mm_add_ps(_mm_unpacklo_ps(a0, a1), _mm_unpackhi_ps(a0, a1));
+        __m128 v = _mm_add_ps(_mm_unpacklo_ps(a2, a3), _mm_unpackhi_ps(a2, a3));
+        _mm_storeu_ps(y + r, _mm_add_ps(_mm_movelh_ps(u, v), _mm_movehl_ps(v, u)));
+    }
+    for (; r < rows; r++) {
+        const int8_t* row = w + (size_t)r * stride;
+        __m128 acc = _mm_setzero_ps();
+        for (uint32_t i = 0; i < stride; i += 16) {
+            __m128 xv[4] = { _mm_loadu_ps(x + i), _mm_loadu_ps(x + i + 4),
+                             _mm_loadu_ps(x + i + 8), _mm_loadu_ps(x + i + 12) };
+            acc = dot16(row + i, xv, acc);
+        }
+        acc = _mm_add_ps(acc, _mm_movehl_ps(acc, acc));
+        acc = _mm_add_ss(acc, _mm_shuffle_ps(acc, acc, 1));
+        y[r] = _mm_cvtss_f32(acc);
+    }
+#elif defined(OD_MODEL_NEON)
+    for (; r < rows; r++) {
+        const int8_t* row = w + (size_t)r * stride;
+        float32x4_t acc = vdupq_n_f32(0.0f);
+        for (uint32_t i = 0; i < stride; i += 16) {
+            int8x16_t b = vld1q_s8(row + i);
+            int16x8_t lo = vmovl_s8(vget_low_s8(b));
+            int16x8_t hi = vmovl_s8(vget_high_s8(b));
+            acc = vmlaq_f32(acc, vcvtq_f32_s32(vmovl_s16(vget_low_s16(lo))), vld1q_f32(x + i));
+            acc = vmlaq_f32(acc, vcvtq_f32_s32(vmovl_s16(vget_high_s16(lo))), vld1q_f32(x + i + 4));
+            acc = vmlaq_f32(acc, vcvtq_f32_s32(vmovl_s16(vget_low_s16(hi))), vld1q_f32(x + i + 8));
+            acc = vmlaq_f32(acc, vcvtq_f32_s32(vmovl_s16(vget_high_s16(hi))), vld1q_f32(x + i + 12));
+        }
+        float32x2_t s = vadd_f32(vget_low_f32(acc), vget_high_f32(acc));
+        y[r] = vget_lane_f32(vpadd_f32(s, s), 0);
+    }
+#endif
+    for (; r < rows; r++) {
+        const int8_t* row = w + (size_t)r * stride;
+        float acc = 0.0f;
+        for (uint32_t i = 0; i < stride; i++) acc += (float)row[i] * x[i];
+        y[r] = acc;
+    }
+}
+
+static void activate(uint32_t activation, float* y, uint32_t n) {
+    if (activation == OD_ACT_RELU) {
+        for (uint32_t i = 0; i < n; i++) y[i] = y[i] > 0.0f ? y[i] : 0.0f;
+    } else if (activation == OD_ACT_SOFTMAX) {
+        float max = y[0];
+        for (uint32_t i = 1; i < n; i++) if (y[i] > max) max = y[i];
+        float sum = 0.0f;
+        for (uint32_t i = 0; i < n; i++) {
+            y[i] = expf(y[i] - max);
+            sum += y[i];
+        }
+        for (uint32_t i = 0; i < n; i++) y[i] /= sum;
+    }
+}
+
+uint32_t od_model_forward(const ClassifierModel_t* m, const float* input, float* output) {
+    if (!m || !input || !output) return 0;
+
+    /* Ping-pong activations, zero past each layer's width so the padded
+     * weight columns multiply zeros. */
+    float buf[2][OD_MODEL_MAX_WIDTH];
+    float* x = buf[0];
+    float* y = buf[1];
+    for (uint32_t i = 0; i < m->inputs; i++) x[i] = (input[i] - m->mean[i]) * m->in_scale[i];
+    for (uint32_t i = m->inputs; i < m->layer[0].stride; i++) x[i] = 0.0f;
+
+    for (uint32_t l = 0; l < m->layers; l++) {
+        const Layer_t* layer = &m->layer[l];
+        gemv_i8(layer->weight, layer->out, layer->stride, x, y);
+        for (uint32_t o = 0; o < layer->out; o++) y[o] = y[o] * layer->scale[o] + layer->bias[o];
+        activate(layer->activation, y, layer->out);
+        for (uint32_t o = layer->out; o < ALIGN16(layer->out); o++) y[o] = 0.0f;
+        float* t = x;
+        x = y;
+        y = t;
+    }
+    memcpy(output, x, m->outputs * sizeof(float));
+    return m->outputs;
+}
+
+int od_model_wants_mfcc(const ClassifierModel_t* m) {
+    return m && m->input_kind != OD_MODEL_INPUT_SPECTRAL;
+}
+
+float od_model_min_energy(const ClassifierModel_t* m) {
+    return m ? m->min_energy : 0.0f;
+}
+
+ClassResult_t od_model_classify(const ClassifierModel_t* m, const SpectralFeatures_t* f, const float* mfcc) {
+    return od_model_score(m, f, mfcc, NULL);
+}
+
+ClassResult_t od_model_score(const ClassifierModel_t* m, const SpectralFeatures_t* f, const float* mfcc,
+                             float* scores) {
+    ClassResult_t result = { SOUND_UNKNOWN, 0.0f };
+    if (scores) {
+        for (int t = 0; t < SOUND_TYPE_COUNT; t++) scores[t] = 0.0f;
+        scores[SOUND_UNKNOWN] = 1.0f;
+    }
+    if (!m || !f || f->energy < m->min_energy) return result;
+    if (od_model_wants_mfcc(m) && !mfcc) return result;
+
+    float in[SPECTRAL_INPUTS + OD_MFCC_FEATURES];
+    uint32_t n = 0;
+    if (m->input_kind != OD_MODEL_INPUT_MFCC) {
+        memcpy(in, f, sizeof(SpectralFeatures_t));
+        n = SPECTRAL_INPUTS;
+    }
+    if (m->input_kind != OD_MODEL_INPUT_SPECTRAL) memcpy(in + n, mfcc, OD_MFCC_FEATURES * sizeof(float));
+
+    float out[OD_MODEL_MAX_WIDTH];
+    if (!od_model_forward(m, in, out)) return result;
+
+    uint32_t best = 0;
+    for (uint32_t o = 1; o < m->outputs; o++) {
+        if (out[o] > out[best]) best = o;
+    }
+    if (scores) {
+        scores[SOUND_UNKNOWN] = m->min_confidence;
+        for (uint32_t o = 0; o < m->outputs; o++) {
+            if (out[o] > scores[m->output_type[o]]) scores[m->output_type[o]] = out[o];
+        }
+    }
+    if (out[best] >= m->min_confidence) {
+        result.type = (SoundType_t)m->output_type[best];
+        result.confidence = result.type == SOUND_UNKNOWN ? 0.0f : out[best];
+    }
+    return result;
+}
@@ -0,0 +1,79 @@
+#ifndef OD_CLASSIFIER_MODEL_H
+#define OD_CLASSIFIER_MODEL_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifdef _WIN32
+#include "classifier_windows.h"
+#else
+#include "classifier.h"
+#endif
+
+/* Small trained classifier: a stack of dense layers with int8 weights,
+ * run on each frame's SpectralFeatures_t, MFCC vector, or both.  Weights
+ * are used straight from the mmapped file; inference allocates nothing
+ * and keeps its activations on the stack.
+ *
+ * File layout (little-endian; every section starts on a 16-byte boundary):
+ *
+ *   header   "ODNN"  u32 version (1)  u32 input_kind (ModelInputKind_t)
+ *            u32 inputs  u32 layers  u32 outputs  f32 min_energy  f32 min_confidence
+ *   f32 mean[inputs], f32 scale[inputs]      x = (feature - mean) * scale
+ *   u8  output_type[outputs]                 SoundType_t of each output
+ *   per layer:
+ *            u32 in  u32 out  u32 activation (0 none, 1 ReLU, 2 softmax)  u32 0
+ *            f32 bias[out], f32 row_scale[out]
+ *            i8  weight[out][stride]         stride = in rounded up to 16, zero padded
+ *
+ *   y[o] = act(row_scale[o] * sum_i weight[o][i] * x[i] + bias[o])
+ *
+ * The class is the output with the highest value (a softmax last layer
+ * makes that a probability); it is reported only when it reaches
+ * min_confidence. */
+
+#define OD_MODEL_MAGIC          "ODNN"
+#define OD_MODEL_VERSION        1
+#define OD_MODEL_MAX_LAYERS     8
+#define OD_MODEL_MAX_WIDTH      256
+
+typedef enum {
+    OD_MODEL_INPUT_SPECTRAL = 0,                /* the 8 SpectralFeatures_t fields */
+    OD_MODEL_INPUT_MFCC,                        /* the OD_MFCC_FEATURES vector */
+    OD_MODEL_INPUT_SPECTRAL_MFCC,               /* both, spectral fields first */
+} ModelInputKind_t;
+
+typedef enum {
+    OD_ACT_NONE = 0,
+    OD_ACT_RELU,
+    OD_ACT_SOFTMAX,
+} ModelActivation_t;
+
+typedef struct ClassifierModel ClassifierModel_t;
+
+/* Maps and validates a model file.  Returns NULL on error. */
+ClassifierModel_t* od_model_open(const char* path);
+void od_model_close(ClassifierModel_t* model);
+
+/* Runs the network on `input` (the model's input count of floats) into
+ * `output`; returns the output count, 0 on error. */
+uint32_t od_model_forward(const ClassifierModel_t* model, const float* input, float* output);
+
+/* `mfcc` may be NULL for spectral-only models; others then report Unknown. */
+ClassResult_t od_model_classify(const ClassifierModel_t* model, const SpectralFeatures_t* features,
+                                const float* mfcc);
+
+/* As above, also filling scores[SOUND_TYPE_COUNT] when not NULL: each
+ * type's highest output, with min_confidence standing in for Unknown.
+ * Below min_energy Unknown scores 1 and the rest 0. */
+ClassResult_t od_model_score(const ClassifierModel_t* model, const SpectralFeatures_t* features,
+                             const float* mfcc, float* scores);
+int od_model_wants_mfcc(const ClassifierModel_t* model);
+float od_model_min_energy(const ClassifierModel_t* model);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
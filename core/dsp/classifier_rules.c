@@ -0,0 +1,372 @@
+#include "classifier_rules.h"
+#include <ctype.h>
+#include <stddef.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define OD_RULES_SSE 1
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define OD_RULES_NEON 1
+#endif
+
+#define LANES 4
+
+/* ──────────────────── Built-in presets ──────────────────── */
+
+const char od_rules_pubg[] =
+    "preset PUBG\n"
+    "min_energy 0.001\n"
+    "min_score 0.4\n"
+    "\n"
+    "# Sniper: very loud, sharp, wide spectrum\n"
+    "class SR\n"
+    "  transient > 0.12 score 0.3\n"
+    "  energy > 0.2 score 0.3\n"
+    "  low_freq_ratio > 0.3 score 0.2\n"
+    "  spectral_spread > 1800 score 0.2\n"
+    "\n"
+    "class AR\n"
+    "  transient > 0.04 <= 0.15 score 0.3\n"
+    "  energy > 0.08 <= 0.3 score 0.2\n"
+    "  mid_freq_ratio > 0.3 score 0.2\n"
+    "  high_freq_ratio > 0.12 score 0.15\n"
+    "  zero_crossing_rate > 0.18 score 0.15\n"
+    "\n"
+    "# SMG: quieter and brighter than AR\n"
+    "class SMG\n"
+    "  transient > 0.03 <= 0.08 score 0.25\n"
+    "  energy > 0.05 <= 0.15 score 0.2\n"
+    "  high_freq_ratio > 0.25 score 0.25\n"
+    "  low_freq_ratio < 0.25 score 0.15\n"
+    "  zero_crossing_rate > 0.3 score 0.15\n"
+    "\n"
+    "class DMR\n"
+    "  transient > 0.08 <= 0.15 score 0.3\n"
+    "  energy > 0.15 <= 0.3 score 0.25\n"
+    "  mid_freq_ratio > 0.35 score 0.2\n"
+    "  low_freq_ratio > 0.2 < 0.4 score 0.15\n"
+    "  spectral_spread > 1500 < 2500 score 0.1\n"
+    "\n"
+    "# Frag: huge low-frequency blast\n"
+    "class Grenade\n"
+    "  transient > 0.2 score 0.35\n"
+    "  energy > 0.4 score 0.25\n"
+    "  low_freq_ratio > 0.5 score 0.25\n"
+    "  high_freq_ratio < 0.15 score 0.15\n"
+    "\n"
+    "# Smoke: soft pop then hiss\n"
+    "class Smoke\n"
+    "  transient < 0.02 score 0.2\n"
+    "  energy > 0.01 < 0.08 score 0.2\n"
+    "  high_freq_ratio > 0.4 score 0.3\n"
+    "  zero_crossing_rate > 0.4 score 0.3\n"
+    "\n"
+    "# Engine drone: steady, low\n"
+    "class Vehicle\n"
+    "  transient < 0.03 score 0.25\n"
+    "  energy > 0.03 < 0.2 score 0.2\n"
+    "  low_freq_ratio > 0.35 score 0.25\n"
+    "  mid_freq_ratio > 0.3 score 0.15\n"
+    "  zero_crossing_rate < 0.25 score 0.15\n"
+    "\n"
+    "class Footstep\n"
+    "  transient > 0.01 < 0.05 score 0.3\n"
+    "  energy > 0.005 < 0.06 score 0.25\n"
+    "  low_freq_ratio > 0.4 score 0.25\n"
+    "  high_freq_ratio < 0.2 score 0.2\n";
+
+/* ──────────────────── Compiled table ──────────────────── */
+
+/* Classes run across the lanes, rules down the rows: cell (row, class)
+ * holds that class's row-th rule, or a zero-score filler.  A vector add per
+ * row then sums each class's rules in file order, exactly as a sequential
+ * if-chain would. */
+struct ClassifierRules {
+    char name[32];
+    float min_energy;
+    float min_score;
+
+    uint32_t classes;
+    uint32_t width;                             /* classes rounded up to LANES */
+    uint32_t rows;                              /* most rules in any class */
+    int32_t type[OD_RULES_MAX_CLASSES];
+
+    uint8_t* feature;                           /* [rows * width] index into SpectralFeatures_t */
+    float* lo;                                  /* pass iff lo < value < hi */
+    float* hi;
+    float* score;                               /* 0 in filler cells */
+};
+
+static const struct {
+    const char* name;
+    size_t offset;
+} features[] = {
+    { "energy",             offsetof(SpectralFeatures_t, energy) },
+    { "spectral_centroid",  offsetof(SpectralFeatures_t, spectral_centroid) },
+    { "spectral_spread",    offsetof(SpectralFeatures_t, spectral_spread) },
+    { "high_freq_ratio",    offsetof(SpectralFeatures_t, high_freq_ratio) },
+    { "low_freq_ratio",     offsetof(SpectralFeatures_t, low_freq_ratio) },
+    { "mid_freq_ratio",     offsetof(SpectralFeatures_t, mid_freq_ratio) },
+    { "transient",          offsetof(SpectralFeatures_t, transient) },
+    { "zero_crossing_rate", offsetof(SpectralFeatures_t, zero_crossing_rate) },
+};
+
+/* ──────────────────── Parsing ──────────────────── */
+
+typedef struct {
+    uint8_t feature;
+    float lo, hi, score;
+} Rule_t;
+
+typedef struct {
+    int32_t type;
+    uint32_t count;
+    Rule_t rules[OD_RULES_MAX_PER_CLASS];
+} ClassDraft_t;
+
+/* Splits `line` in place on whitespace; returns the token count. */
+static int tokenize(char* line, char** tok, int max) {
+    int n = 0;
+    char* p = line;
+    while (*p && n < max) {
+        while (*p && isspace((unsigned char)*p)) p++;
+        if (!*p) break;
+        tok[n++] = p;
+        while (*p && !isspace((unsigned char)*p)) p++;
+        if (*p) *p++ = '\0';
+    }
+    return n;
+}
+
+static int parse_float(const char* s, float* out) {
+    char* end;
+    double v = strtod(s, &end);
+    if (end == s || *end) return 0;
+    *out = (float)v;
+    return 1;
+}
+
+static int find_feature(const char* name) {
+    for (size_t i = 0; i < sizeof(features) / sizeof(features[0]); i++) {
+        if (strcmp(features[i].name, name) == 0) return (int)(features[i].offset / sizeof(float));
+    }
+    return -1;
+}
+
+static int find_type(const char* name) {
+    for (int t = 0; t < SOUND_TYPE_COUNT; t++) {
+        const char* tn = OD_Classifier_TypeName((SoundType_t)t);
+        size_t i = 0;
+        while (tn[i] && tolower((unsigned char)tn[i]) == tolower((unsigned char)name[i])) i++;
+        if (!tn[i] && !name[i]) return t;
+    }
+    return -1;
+}
+
+/* Applies one "<op> <value>" bound to [lo, hi]. */
+static int apply_bound(const char* op, const char* value, Rule_t* r) {
+    float v;
+    if (!parse_float(value, &v)) return 0;
+    if (strcmp(op, ">") == 0) r->lo = v;
+    else if (strcmp(op, ">=") == 0) r->lo = nextafterf(v, -INFINITY);
+    else if (strcmp(op, "<") == 0) r->hi = v;
+    else if (strcmp(op, "<=") == 0) r->hi = nextafterf(v, INFINITY);
+    else return 0;
+    return 1;
+}
+
+static ClassifierRules_t* build(const char* name, float min_energy, float min_score,
+                                const ClassDraft_t* drafts, uint32_t classes) {
+    ClassifierRules_t* r = (ClassifierRules_t*)calloc(1, sizeof(ClassifierRules_t));
+    if (!r) return NULL;
+    snprintf(r->name, sizeof(r->name), "%s", name);
+    r->min_energy = min_energy;
+    r->min_score = min_score;
+    r->classes = classes;
+    r->width = (classes + LANES - 1) / LANES * LANES;
+    for (uint32_t c = 0; c < classes; c++) {
+        r->type[c] = drafts[c].type;
+        if (drafts[c].count > r->rows) r->rows = drafts[c].count;
+    }
+
+    size_t cells = (size_t)(r->rows ? r->rows : 1) * r->width;
+    r->feature = (uint8_t*)calloc(cells, 1);
+    r->lo = (float*)malloc(cells * sizeof(float));
+    r->hi = (float*)malloc(cells * sizeof(float));
+    r->score = (float*)calloc(cells, sizeof(float));
+    if (!r->feature || !r->lo || !r->hi || !r->score) {
+        od_rules_free(r);
+        return NULL;
+    }
+    for (size_t i = 0; i < cells; i++) {
+        r->lo[i] = -INFINITY;
+        r->hi[i] = INFINITY;
+    }
+    for (uint32_t c = 0; c < classes; c++) {
+        for (uint32_t i = 0; i < drafts[c].count; i++) {
+            size_t cell = (size_t)i * r->width + c;
+            r->feature[cell] = drafts[c].rules[i].feature;
+            r->lo[cell] = drafts[c].rules[i].lo;
+            r->hi[cell] = drafts[c].rules[i].hi;
+            r->score[cell] = drafts[c].rules[i].score;
+        }
+    }
+    return r;
+}
+
+ClassifierRules_t* od_rules_compile(const char* text, const char* origin) {
+    if (!text) return NULL;
+    ClassDraft_t* drafts = (ClassDraft_t*)calloc(OD_RULES_MAX_CLASSES, sizeof(ClassDraft_t));
+    if (!drafts) return NULL;
+
+    char name[32] = "custom";
+    float min_energy = 0.001f, min_score = 0.4f;
+    uint32_t classes = 0;
+    int line_no = 0;
+    const char* error = NULL;
+    const char* p = text;
+
+    while (*p && !error) {
+        char line[256];
+        size_t len = strcspn(p, "\n");
+        snprintf(line, sizeof(line), "%.*s", (int)(len < sizeof(line) ? len : sizeof(line) - 1), p);
+        p += len + (p[len] == '\n');
+        line_no++;
+
+        char* hash = strchr(line, '#');
+        if (hash) *hash = '\0';
+        char* tok[8];
+        int n = tokenize(line, tok, 8);
+        if (n == 0) continue;
+
+        if (strcmp(tok[0], "preset") == 0 && n == 2) {
+            snprintf(name, sizeof(name), "%s", tok[1]);
+        } else if (strcmp(tok[0], "min_energy") == 0 && n == 2) {
+            if (!parse_float(tok[1], &min_energy)) error = "bad number";
+        } else if (strcmp(tok[0], "min_score") == 0 && n == 2) {
+            if (!parse_float(tok[1], &min_score)) error = "bad number";
+        } else if (strcmp(tok[0], "class") == 0 && n == 2) {
+            int type = find_type(tok[1]);
+            if (type < 0) error = "unknown sound type";
+            else if (classes == OD_RULES_MAX_CLASSES) error = "too many classes";
+            else drafts[classes++].type = type;
+        } else {
+            /* <feature> <op> <value> [<op> <value>] score <weight> */
+            int feature = find_feature(tok[0]);
+            Rule_t rule = { 0, -INFINITY, INFINITY, 0.0f };
+            if (feature < 0) error = "unknown feature or keyword";
+            else if (classes == 0) error = "rule before the first class";
+            else if ((n != 5 && n != 7) || strcmp(tok[n - 2], "score") != 0) error = "expected <feature> <op> <value> [<op> <value>] score <weight>";
+            else if (!apply_bound(tok[1], tok[2], &rule) || (n == 7 && !apply_bound(tok[3], tok[4], &rule))) error = "bad bound";
+            else if (!parse_float(tok[n - 1], &rule.score)) error = "bad score";
+            else if (drafts[classes - 1].count == OD_RULES_MAX_PER_CLASS) error = "too many rules in class";
+            else {
+                rule.feature = (uint8_t)feature;
+                drafts[classes - 1].rules[drafts[classes - 1].count++] = rule;
+            }
+        }
+    }
+
+    ClassifierRules_t* rules = NULL;
+    if (error) printf("[Classifier] %s:%d: %s\n", origin ? origin : "preset", line_no, error);
+    else if (classes == 0) printf("[Classifier] %s: no classes defined\n", origin ? origin : "preset");
+    else rules = build(name, min_energy, min_score, drafts, classes);
+    free(drafts);
+    return rules;
+}
+
+void od_rules_free(ClassifierRules_t* rules) {
+    if (!rules) return;
+    free(rules->feature);
+    free(rules->lo);
+    free(rules->hi);
+    free(rules->score);
+    free(rules);
+}
+
+const char* od_rules_name(const ClassifierRules_t* rules) {
+    return rules ? rules->name : "none";
+}
+
+float od_rules_min_energy(const ClassifierRules_t* rules) {
+    return rules ? rules->min_energy : 0.0f;
+}
+
+/* ──────────────────── Evaluation ──────────────────── */
+
+/* Scores classes [c, c + LANES) into out[0..LANES). */
+static void score_lanes(const ClassifierRules_t* r, const float* fv, uint32_t c, float* out) {
+#if defined(OD_RULES_SSE)
+    __m128 acc = _mm_setzero_ps();
+    for (uint32_t row = 0; row < r->rows; row++) {
+        size_t i = (size_t)row * r->width + c;
+        const uint8_t* ft = r->feature + i;
+        __m128 v = _mm_setr_ps(fv[ft[0]], fv[ft[1]], fv[ft[2]], fv[ft[3]]);
+        __m128 pass = _mm_and_ps(_mm_cmpgt_ps(v, _mm_loadu_ps(r->lo + i)), _mm_cmplt_ps(v, _mm_loadu_ps(r->hi + i)));
+        acc = _mm_add_ps(acc, _mm_and_ps(pass, _mm_loadu_ps(r->score + i)));
+    }
+    _mm_storeu_ps(out, acc);
+#elif defined(OD_RULES_NEON)
+    float32x4_t acc = vdupq_n_f32(0.0f);
+    for (uint32_t row = 0; row < r->rows; row++) {
+        size_t i = (size_t)row * r->width + c;
+        const uint8_t* ft = r->feature + i;
+        float gathered[LANES] = { fv[ft[0]], fv[ft[1]], fv[ft[2]], fv[ft[3]] };
+        float32x4_t v = vld1q_f32(gathered);
+        uint32x4_t pass = vandq_u32(vcgtq_f32(v, vld1q_f32(r->lo + i)), vcltq_f32(v, vld1q_f32(r->hi + i)));
+        acc = vaddq_f32(acc, vreinterpretq_f32_u32(vandq_u32(pass, vreinterpretq_u32_f32(vld1q_f32(r->score + i)))));
+    }
+    vst1q_f32(out, acc);
+#else
+    for (uint32_t l = 0; l < LANES; l++) out[l] = 0.0f;
+    for (uint32_t row = 0; row < r->rows; row++) {
+        size_t i = (size_t)row * r->width + c;
+        for (uint32_t l = 0; l < LANES; l++) {
+            float v = fv[r->feature[i + l]];
+            out[l] += (v > r->lo[i + l] && v < r->hi[i + l]) ? r->score[i + l] : 0.0f;
+        }
+    }
+#endif
+}
+
+ClassResult_t od_rules_evaluate(const ClassifierRules_t* r, const SpectralFeatures_t* f) {
+    return od_rules_score(r, f, NULL);
+}
+
+ClassResult_t od_rules_score(const ClassifierRules_t* r, const SpectralFeatures_t* f, float* scores) {
+    ClassResult_t result = { SOUND_UNKNOWN, 0.0f };
+    if (scores) {
+        for (int t = 0; t < SOUND_TYPE_COUNT; t++) scores[t] = 0.0f;
+        scores[SOUND_UNKNOWN] = 1.0f;
+    }
+    if (!r || !f || f->energy < r->min_energy) return result;
+
+    const float* fv = (const float*)f;
+    float score[OD_RULES_MAX_CLASSES];
+    for (uint32_t c = 0; c < r->width; c += LANES) score_lanes(r, fv, c, score + c);
+
+    SoundType_t best_type = SOUND_UNKNOWN;
+    float best_score = 0.0f;
+    for (uint32_t c = 0; c < r->classes; c++) {
+        if (score[c] > best_score) {
+            best_score = score[c];
+            best_type = (SoundType_t)r->type[c];
+        }
+    }
+    if (scores) {
+        scores[SOUND_UNKNOWN] = r->min_score;
+        for (uint32_t c = 0; c < r->classes; c++) {
+            if (score[c] > scores[r->type[c]]) scores[r->type[c]] = score[c];
+        }
+    }
+
+    if (best_score >= r->min_score) {
+        result.type = best_type;
+        result.confidence = best_score;
+    }
+    return result;
+}
@@ -0,0 +1,60 @@
+#ifndef OD_CLASSIFIER_RULES_H
+#define OD_CLASSIFIER_RULES_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifdef _WIN32
+#include "classifier_windows.h"
+#else
+#include "classifier.h"
+#endif
+
+/* Rule-based classifier presets, loaded from text and compiled into a flat
+ * table.
+ *
+ *   # comment
+ *   preset PUBG
+ *   min_energy 0.001           # below this nothing is classified
+ *   min_score 0.4              # best class must reach this
+ *   class SR                   # SoundType_t name, as OD_Classifier_TypeName
+ *     transient > 0.12 score 0.3
+ *     transient > 0.04 <= 0.15 score 0.3
+ *     low_freq_ratio < 0.25 score 0.15
+ *
+ * A rule adds its score to its class when the feature passes every bound
+ * given (> >= < <=).  Features are the SpectralFeatures_t field names.  The
+ * highest-scoring class wins; ties go to the class listed first.
+ *
+ * Compiled, every rule becomes one cell of (feature, lo, hi, score), with
+ * inclusive bounds nudged to exclusive ones.  Classes sit side by side in
+ * SIMD lanes, so each row of rules costs two compares, an AND and an add
+ * for four classes at once, with no per-rule branches. */
+
+#define OD_RULES_MAX_CLASSES    32
+#define OD_RULES_MAX_PER_CLASS  32
+
+typedef struct ClassifierRules ClassifierRules_t;
+
+/* `origin` names the source in error messages.  Returns NULL on error. */
+ClassifierRules_t* od_rules_compile(const char* text, const char* origin);
+void od_rules_free(ClassifierRules_t* rules);
+const char* od_rules_name(const ClassifierRules_t* rules);
+float od_rules_min_energy(const ClassifierRules_t* rules);
+
+ClassResult_t od_rules_evaluate(const ClassifierRules_t* rules, const SpectralFeatures_t* features);
+
+/* As above, also filling scores[SOUND_TYPE_COUNT] when not NULL: each
+ * type's best class score, with min_score standing in for Unknown.  Below
+ * min_energy (or without rules) Unknown scores 1 and the rest 0. */
+ClassResult_t od_rules_score(const ClassifierRules_t* rules, const SpectralFeatures_t* features, float* scores);
+
+/* The built-in PUBG preset, in the format above. */
+extern const char od_rules_pubg[];
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -1,14 +1,34 @@
 #include "classifier_windows.h"
+#include "classifier_model.h"
+#include "classifier_rules.h"
 #include <math.h>
+#include <stdatomic.h>
+#include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#endif
 
 #define PI 3.14159265358979323846f
 
 
-static Preset_t active_preset = { "none", 0 };
+/* The active preset is a compiled rule table, and the optional model a
+ * mapped network; each is swapped in whole, so either can be replaced while
+ * the DSP threads keep classifying.  Readers bump `classifying` around each
+ * use; the swapper waits for it to drain before freeing what it replaced.
+ * A loaded model takes precedence over the rules. */
+static _Atomic(ClassifierRules_t*) active_rules;
+static _Atomic(ClassifierModel_t*) active_model;
+static atomic_int classifying;
 static SpectralFeatures_t prev_features = {0};
 
+static struct {
+    _Atomic uint64_t calls;
+    _Atomic uint64_t gated;
+} stats;
 
 static const char* type_names[] = {
     "Unknown",
@@ -22,27 +42,100 @@ static const char* type_names[] = {
     "Vehicle",
 };
 
+static void sleep_1ms(void) {
+#ifdef _WIN32
+    Sleep(1);
+#else
+    struct timespec ts = { 0, 1000000L };
+    nanosleep(&ts, NULL);
+#endif
+}
+
+static void wait_for_readers(void) {
+    while (atomic_load(&classifying) != 0) sleep_1ms();
+}
+
+static void swap_rules(ClassifierRules_t* rules) {
+    ClassifierRules_t* old = atomic_exchange(&active_rules, rules);
+    if (!old) return;
+    wait_for_readers();
+    od_rules_free(old);
+}
+
+static void swap_model(ClassifierModel_t* model) {
+    ClassifierModel_t* old = atomic_exchange(&active_model, model);
+    if (!old) return;
+    wait_for_readers();
+    od_model_close(old);
+}
+
 void OD_Classifier_Init(void) {
     memset(&prev_features, 0, sizeof(prev_features));
-    active_preset.name = "none";
-    active_preset.enabled = 0;
+    atomic_store(&stats.calls, 0);
+    atomic_store(&stats.gated, 0);
+    swap_rules(NULL);
+    swap_model(NULL);
     printf("[Classifier] Initialized\n");
 }
 
+static char* read_text(const char* path) {
+    FILE* f = fopen(path, "rb");
+    if (!f) return NULL;
+    char* text = NULL;
+    if (fseek(f, 0, SEEK_END) == 0) {
+        long size = ftell(f);
+        if (size >= 0 && fseek(f, 0, SEEK_SET) == 0 && (text = (char*)malloc((size_t)size + 1))) {
+            size_t got = fread(text, 1, (size_t)size, f);
+            text[got] = '\0';
+        }
+    }
+    fclose(f);
+    return text;
+}
+
+int OD_Classifier_LoadPreset(const char* path) {
+    if (!path) return 0;
+    char* text = read_text(path);
+    if (!text) {
+        printf("[Classifier] Cannot read preset %s\n", path);
+        return 0;
+    }
+    ClassifierRules_t* rules = od_rules_compile(text, path);
+    free(text);
+    if (!rules) return 0;
+    swap_rules(rules);
+    printf("[Classifier] Preset set to %s (%s)\n", od_rules_name(rules), path);
+    return 1;
+}
+
 void OD_Classifier_SetPreset(const char* preset_name) {
+    if (!preset_name) return;
     if (strcmp(preset_name, "pubg") == 0 || strcmp(preset_name, "PUBG") == 0) {
-        active_preset.name = "PUBG";
-        active_preset.enabled = 1;
+        ClassifierRules_t* rules = od_rules_compile(od_rules_pubg, "built-in PUBG preset");
+        if (!rules) return;
+        swap_rules(rules);
         printf("[Classifier] Preset set to PUBG (rule-based)\n");
     } else if (strcmp(preset_name, "none") == 0) {
-        active_preset.name = "none";
-        active_preset.enabled = 0;
+        swap_rules(NULL);
         printf("[Classifier] Classification disabled\n");
-    } else {
+    } else if (!OD_Classifier_LoadPreset(preset_name)) {
         printf("[Classifier] Unknown preset: %s\n", preset_name);
     }
 }
 
+int OD_Classifier_LoadModel(const char* path) {
+    if (!path || !*path) {
+        swap_model(NULL);
+        printf("[Classifier] Model unloaded, using the preset rules\n");
+        return 1;
+    }
+    ClassifierModel_t* model = od_model_open(path);
+    if (!model) return 0;
+    swap_model(model);
+    printf("[Classifier] Model loaded from %s\n", path);
+    return 1;
+}
+
 const char* OD_Classifier_TypeName(SoundType_t type) {
     if (type >= 0 && type < SOUND_TYPE_COUNT)
         return type_names[type];
@@ -77,31 +170,50 @@ static float band_energy(const float* samples, uint32_t n, float freq_low, float
 
 SpectralFeatures_t OD_Classifier_ExtractFeatures(const float* left, const float* right,
                                                    uint32_t num_samples, uint32_t sample_rate) {
-    SpectralFeatures_t f;
-    memset(&f, 0, sizeof(f));
+    return OD_Classifier_ExtractFeaturesFrom(left, right, num_samples, sample_rate, &prev_features);
+}
 
-    if (!left || !right || num_samples == 0) return f;
+/* Spectral band of a cached |X[k]|^2 / n spectrum.  The rules were tuned
+ * on band_energy(), which sums at most ~8 sampled bins of an n-point DFT;
+ * the band's mean power is scaled by that same bin count so the ratios,
+ * centroid and spread keep their calibration. */
+static float spectrum_band_energy(const float* power, uint32_t fft_size, uint32_t n,
+                                  float freq_low, float freq_high, uint32_t sample_rate) {
+    uint32_t bin_low = (uint32_t)(freq_low * n / sample_rate);
+    uint32_t bin_high = (uint32_t)(freq_high * n / sample_rate);
+    if (bin_low < 1) bin_low = 1;
+    if (bin_high > n / 2) bin_high = n / 2;
+    if (bin_high <= bin_low) return 0.0f;
+    uint32_t step = (bin_high - bin_low);
+    if (step > 8) step = step / 8;
+    if (step < 1) step = 1;
+    uint32_t visits = (bin_high - bin_low + step - 1) / step;
 
-    
+    uint32_t k_low = (uint32_t)(freq_low * fft_size / sample_rate);
+    uint32_t k_high = (uint32_t)(freq_high * fft_size / sample_rate);
+    if (k_low < 1) k_low = 1;
+    if (k_high > fft_size / 2) k_high = fft_size / 2;
+    if (k_high <= k_low) k_high = k_low + 1;
+
+    float sum = 0.0f;
+    for (uint32_t k = k_low; k < k_high; k++) sum += power[k];
+    return sum / (float)(k_high - k_low) * (float)visits;
+}
+
+/* Mono downmix of the first n (<= 512) samples. */
+static uint32_t downmix_mono(const float* left, const float* right, uint32_t num_samples, float* mono) {
     uint32_t n = num_samples;
     if (n > 512) n = 512;
-
-    float mono[512];
     for (uint32_t i = 0; i < n; i++) {
         mono[i] = (left[i] + right[i]) * 0.5f;
     }
+    return n;
+}
 
-    
-    float sum_sq = 0.0f;
-    for (uint32_t i = 0; i < n; i++) {
-        sum_sq += mono[i] * mono[i];
-    }
-    f.energy = sqrtf(sum_sq / n);
-
-    
-    float e_low  = band_energy(mono, n, 20.0f, 300.0f, sample_rate);    
-    float e_mid  = band_energy(mono, n, 300.0f, 4000.0f, sample_rate);  
-    float e_high = band_energy(mono, n, 4000.0f, 12000.0f, sample_rate); 
+/* Ratios, centroid, spread and transient from the three band energies;
+ * `f` already holds the energy and zero-crossing rate. */
+static SpectralFeatures_t band_features(SpectralFeatures_t f, float e_low, float e_mid, float e_high,
+                                        SpectralFeatures_t* prev) {
     float e_total = e_low + e_mid + e_high;
 
     if (e_total > 0.0001f) {
@@ -125,9 +237,26 @@ SpectralFeatures_t OD_Classifier_ExtractFeatures(const float* left, const float*
     }
 
     
-    f.transient = f.energy - prev_features.energy;
+    f.transient = f.energy - prev->energy;
     if (f.transient < 0) f.transient = 0;
 
+    *prev = f;
+    return f;
+}
+
+/* Everything but the band energies, which the callers measure their own way. */
+static SpectralFeatures_t finish_features(const float* mono, uint32_t n, float e_low, float e_mid, float e_high,
+                                          SpectralFeatures_t* prev) {
+    SpectralFeatures_t f;
+    memset(&f, 0, sizeof(f));
+
+    
+    float sum_sq = 0.0f;
+    for (uint32_t i = 0; i < n; i++) {
+        sum_sq += mono[i] * mono[i];
+    }
+    f.energy = sqrtf(sum_sq / n);
+
     
     uint32_t crossings = 0;
     for (uint32_t i = 1; i < n; i++) {
@@ -136,124 +265,138 @@ SpectralFeatures_t OD_Classifier_ExtractFeatures(const float* left, const float*
     }
     f.zero_crossing_rate = (float)crossings / (float)n;
 
-    prev_features = f;
-    return f;
+    return band_features(f, e_low, e_mid, e_high, prev);
 }
 
-ClassResult_t OD_Classifier_Classify(const SpectralFeatures_t* f) {
-    ClassResult_t result = { SOUND_UNKNOWN, 0.0f };
+SpectralFeatures_t OD_Classifier_ExtractFeaturesFrom(const float* left, const float* right,
+                                                       uint32_t num_samples, uint32_t sample_rate,
+                                                       SpectralFeatures_t* prev) {
+    SpectralFeatures_t f;
+    memset(&f, 0, sizeof(f));
 
-    if (!active_preset.enabled || !f || f->energy < 0.001f) {
-        return result;
-    }
+    if (!left || !right || num_samples == 0) return f;
 
-    
-    SoundType_t best_type = SOUND_UNKNOWN;
-    float best_score = 0.0f;
+    float mono[512];
+    uint32_t n = downmix_mono(left, right, num_samples, mono);
 
-    
-    
-    
-    
+    float e_low  = band_energy(mono, n, 20.0f, 300.0f, sample_rate);    
+    float e_mid  = band_energy(mono, n, 300.0f, 4000.0f, sample_rate);  
+    float e_high = band_energy(mono, n, 4000.0f, 12000.0f, sample_rate); 
+    return finish_features(mono, n, e_low, e_mid, e_high, prev);
+}
 
-    
-    
-    
-    {
-        float score = 0.0f;
-        if (f->transient > 0.12f) score += 0.3f;      
-        if (f->energy > 0.2f) score += 0.3f;           
-        if (f->low_freq_ratio > 0.3f) score += 0.2f;
-        if (f->spectral_spread > 1800.0f) score += 0.2f;
-        if (score > best_score) { best_score = score; best_type = SOUND_SR; }
-    }
+SpectralFeatures_t OD_Classifier_FeaturesFromSpectrum(const float* left, const float* right, uint32_t num_samples,
+                                                        const float* power, uint32_t fft_size, uint32_t sample_rate,
+                                                        SpectralFeatures_t* prev) {
+    SpectralFeatures_t f;
+    memset(&f, 0, sizeof(f));
 
-    
-    
-    {
-        float score = 0.0f;
-        if (f->transient > 0.04f && f->transient <= 0.15f) score += 0.3f;
-        if (f->energy > 0.08f && f->energy <= 0.3f) score += 0.2f;
-        if (f->mid_freq_ratio > 0.3f) score += 0.2f;
-        if (f->high_freq_ratio > 0.12f) score += 0.15f;
-        if (f->zero_crossing_rate > 0.18f) score += 0.15f;
-        if (score > best_score) { best_score = score; best_type = SOUND_AR; }
-    }
+    if (!left || !right || !power || num_samples == 0 || fft_size == 0 || sample_rate == 0) return f;
 
-    
-    
-    {
-        float score = 0.0f;
-        if (f->transient > 0.03f && f->transient <= 0.08f) score += 0.25f;
-        if (f->energy > 0.05f && f->energy <= 0.15f) score += 0.2f;
-        if (f->high_freq_ratio > 0.25f) score += 0.25f;    
-        if (f->low_freq_ratio < 0.25f) score += 0.15f;      
-        if (f->zero_crossing_rate > 0.3f) score += 0.15f;   
-        if (score > best_score) { best_score = score; best_type = SOUND_SMG; }
-    }
+    float mono[512];
+    uint32_t n = downmix_mono(left, right, num_samples, mono);
 
-    
-    
-    {
-        float score = 0.0f;
-        if (f->transient > 0.08f && f->transient <= 0.15f) score += 0.3f;
-        if (f->energy > 0.15f && f->energy <= 0.3f) score += 0.25f;
-        if (f->mid_freq_ratio > 0.35f) score += 0.2f;
-        if (f->low_freq_ratio > 0.2f && f->low_freq_ratio < 0.4f) score += 0.15f;
-        if (f->spectral_spread > 1500.0f && f->spectral_spread < 2500.0f) score += 0.1f;
-        if (score > best_score) { best_score = score; best_type = SOUND_DMR; }
-    }
+    float e_low  = spectrum_band_energy(power, fft_size, n, 20.0f, 300.0f, sample_rate);
+    float e_mid  = spectrum_band_energy(power, fft_size, n, 300.0f, 4000.0f, sample_rate);
+    float e_high = spectrum_band_energy(power, fft_size, n, 4000.0f, 12000.0f, sample_rate);
+    return finish_features(mono, n, e_low, e_mid, e_high, prev);
+}
 
-    
-    
-    {
-        float score = 0.0f;
-        if (f->transient > 0.2f) score += 0.35f;        
-        if (f->energy > 0.4f) score += 0.25f;           
-        if (f->low_freq_ratio > 0.5f) score += 0.25f;   
-        if (f->high_freq_ratio < 0.15f) score += 0.15f;  
-        if (score > best_score) { best_score = score; best_type = SOUND_GRENADE; }
-    }
+/* Sum of a sparse spectrum over [freq_low, freq_high), calibrated like
+ * spectrum_band_energy() over a spectrum that is zero off the listed bins. */
+static float sparse_band_energy(const float* power, const uint16_t* bins, uint32_t count, uint32_t fft_size,
+                                uint32_t n, float freq_low, float freq_high, uint32_t sample_rate) {
+    uint32_t bin_low = (uint32_t)(freq_low * n / sample_rate);
+    uint32_t bin_high = (uint32_t)(freq_high * n / sample_rate);
+    if (bin_low < 1) bin_low = 1;
+    if (bin_high > n / 2) bin_high = n / 2;
+    if (bin_high <= bin_low) return 0.0f;
+    uint32_t step = (bin_high - bin_low);
+    if (step > 8) step = step / 8;
+    if (step < 1) step = 1;
+    uint32_t visits = (bin_high - bin_low + step - 1) / step;
 
-    
-    
-    {
-        float score = 0.0f;
-        if (f->transient < 0.02f) score += 0.2f;         
-        if (f->energy > 0.01f && f->energy < 0.08f) score += 0.2f; 
-        if (f->high_freq_ratio > 0.4f) score += 0.3f;     
-        if (f->zero_crossing_rate > 0.4f) score += 0.3f;   
-        if (score > best_score) { best_score = score; best_type = SOUND_SMOKE; }
-    }
+    uint32_t k_low = (uint32_t)(freq_low * fft_size / sample_rate);
+    uint32_t k_high = (uint32_t)(freq_high * fft_size / sample_rate);
+    if (k_low < 1) k_low = 1;
+    if (k_high > fft_size / 2) k_high = fft_size / 2;
+    if (k_high <= k_low) k_high = k_low + 1;
 
-    
-    
-    {
-        float score = 0.0f;
-        if (f->transient < 0.03f) score += 0.25f;        
-        if (f->energy > 0.03f && f->energy < 0.2f) score += 0.2f;
-        if (f->low_freq_ratio > 0.35f) score += 0.25f;   
-        if (f->mid_freq_ratio > 0.3f) score += 0.15f;    
-        if (f->zero_crossing_rate < 0.25f) score += 0.15f; 
-        if (score > best_score) { best_score = score; best_type = SOUND_VEHICLE; }
+    float sum = 0.0f;
+    for (uint32_t i = 0; i < count; i++) {
+        if (bins[i] >= k_low && bins[i] < k_high) sum += power[i];
     }
+    return sum / (float)(k_high - k_low) * (float)visits;
+}
 
-    
-    
-    {
-        float score = 0.0f;
-        if (f->transient > 0.01f && f->transient < 0.05f) score += 0.3f; 
-        if (f->energy > 0.005f && f->energy < 0.06f) score += 0.25f;     
-        if (f->low_freq_ratio > 0.4f) score += 0.25f;     
-        if (f->high_freq_ratio < 0.2f) score += 0.2f;      
-        if (score > best_score) { best_score = score; best_type = SOUND_FOOTSTEP; }
-    }
+SpectralFeatures_t OD_Classifier_FeaturesFromBins(const float* power, const uint16_t* bins, uint32_t count,
+                                                   uint32_t num_samples, uint32_t fft_size, uint32_t sample_rate,
+                                                   SpectralFeatures_t* prev) {
+    SpectralFeatures_t f;
+    memset(&f, 0, sizeof(f));
 
-    
-    if (best_score >= 0.4f) {
-        result.type = best_type;
-        result.confidence = best_score;
+    if (!power || !bins || count == 0 || num_samples == 0 || fft_size == 0 || sample_rate == 0) return f;
+    uint32_t n = num_samples > 512 ? 512 : num_samples;
+
+    /* Parseval over the one-sided spectrum gives the mean square; Rice's
+     * formula, 2 sqrt(m2 / m0) crossings per second, stands in for the
+     * time-domain zero-crossing count. */
+    float df = (float)sample_rate / (float)fft_size;
+    float m0 = 0.0f, m2 = 0.0f;
+    for (uint32_t i = 0; i < count; i++) {
+        float hz = (float)bins[i] * df;
+        m0 += power[i];
+        m2 += power[i] * hz * hz;
     }
+    f.energy = sqrtf(2.0f * m0 / (float)fft_size);
+    if (m0 > 0.0f) f.zero_crossing_rate = 2.0f * sqrtf(m2 / m0) / (float)sample_rate;
+
+    float e_low  = sparse_band_energy(power, bins, count, fft_size, n, 20.0f, 300.0f, sample_rate);
+    float e_mid  = sparse_band_energy(power, bins, count, fft_size, n, 300.0f, 4000.0f, sample_rate);
+    float e_high = sparse_band_energy(power, bins, count, fft_size, n, 4000.0f, 12000.0f, sample_rate);
+    return band_features(f, e_low, e_mid, e_high, prev);
+}
+
+ClassResult_t OD_Classifier_Classify(const SpectralFeatures_t* f) {
+    return OD_Classifier_ClassifyFrame(f, NULL);
+}
 
+int OD_Classifier_WantsMFCC(void) {
+    atomic_fetch_add(&classifying, 1);
+    int wants = od_model_wants_mfcc(atomic_load(&active_model));
+    atomic_fetch_sub_explicit(&classifying, 1, memory_order_release);
+    return wants;
+}
+
+int OD_Classifier_NeedsMFCC(const SpectralFeatures_t* f) {
+    atomic_fetch_add(&classifying, 1);
+    ClassifierModel_t* model = atomic_load(&active_model);
+    int needs = f && od_model_wants_mfcc(model) && f->energy >= od_model_min_energy(model);
+    atomic_fetch_sub_explicit(&classifying, 1, memory_order_release);
+    return needs;
+}
+
+ClassResult_t OD_Classifier_ClassifyFrame(const SpectralFeatures_t* f, const float* mfcc) {
+    return OD_Classifier_ScoreFrame(f, mfcc, NULL);
+}
+
+ClassResult_t OD_Classifier_ScoreFrame(const SpectralFeatures_t* f, const float* mfcc, float* scores) {
+    /* Sequentially consistent: the swapper must either see this reader or
+     * the reader must see the new table. */
+    atomic_fetch_add(&classifying, 1);
+    ClassifierModel_t* model = atomic_load(&active_model);
+    ClassifierRules_t* rules = atomic_load(&active_rules);
+    ClassResult_t result = model ? od_model_score(model, f, mfcc, scores) : od_rules_score(rules, f, scores);
+    float min_energy = model ? od_model_min_energy(model) : od_rules_min_energy(rules);
+    atomic_fetch_sub_explicit(&classifying, 1, memory_order_release);
+
+    atomic_fetch_add_explicit(&stats.calls, 1, memory_order_relaxed);
+    if (f && f->energy < min_energy) atomic_fetch_add_explicit(&stats.gated, 1, memory_order_relaxed);
     return result;
 }
+
+void OD_Classifier_GetStats(ClassifierStats_t* out) {
+    if (!out) return;
+    out->calls = atomic_load_explicit(&stats.calls, memory_order_relaxed);
+    out->gated = atomic_load_explicit(&stats.gated, memory_order_relaxed);
+}
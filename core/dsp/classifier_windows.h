@@ -36,6 +36,15 @@ typedef struct {
     float zero_crossing_rate; 
 } SpectralFeatures_t;
 
+typedef struct {
+    uint64_t calls;
+    uint64_t gated;
+} ClassifierStats_t;
+
+#define OD_MFCC_BANDS       32
+#define OD_MFCC_COEFFS      13
+#define OD_MFCC_FEATURES    (3 * OD_MFCC_COEFFS)
+
 typedef struct {
     const char* name;       
     int enabled;            
@@ -43,8 +52,18 @@ typedef struct {
 
 __declspec(dllexport) void OD_Classifier_Init(void);
 __declspec(dllexport) void OD_Classifier_SetPreset(const char* preset_name);
+__declspec(dllexport) int OD_Classifier_LoadPreset(const char* path);
+__declspec(dllexport) int OD_Classifier_LoadModel(const char* path);
 __declspec(dllexport) SpectralFeatures_t OD_Classifier_ExtractFeatures(const float* left, const float* right, uint32_t num_samples, uint32_t sample_rate);
+__declspec(dllexport) SpectralFeatures_t OD_Classifier_ExtractFeaturesFrom(const float* left, const float* right, uint32_t num_samples, uint32_t sample_rate, SpectralFeatures_t* prev);
+__declspec(dllexport) SpectralFeatures_t OD_Classifier_FeaturesFromSpectrum(const float* left, const float* right, uint32_t num_samples, const float* power, uint32_t fft_size, uint32_t sample_rate, SpectralFeatures_t* prev);
+__declspec(dllexport) SpectralFeatures_t OD_Classifier_FeaturesFromBins(const float* power, const uint16_t* bins, uint32_t count, uint32_t num_samples, uint32_t fft_size, uint32_t sample_rate, SpectralFeatures_t* prev);
 __declspec(dllexport) ClassResult_t OD_Classifier_Classify(const SpectralFeatures_t* features);
+__declspec(dllexport) ClassResult_t OD_Classifier_ClassifyFrame(const SpectralFeatures_t* features, const float* mfcc);
+__declspec(dllexport) ClassResult_t OD_Classifier_ScoreFrame(const SpectralFeatures_t* features, const float* mfcc, float* scores);
+__declspec(dllexport) void OD_Classifier_GetStats(ClassifierStats_t* stats);
+__declspec(dllexport) int OD_Classifier_WantsMFCC(void);
+__declspec(dllexport) int OD_Classifier_NeedsMFCC(const SpectralFeatures_t* features);
 __declspec(dllexport) const char* OD_Classifier_TypeName(SoundType_t type);
 
 #ifdef __cplusplus
@@ -0,0 +1,68 @@
+#include "decimator.h"
+#include <math.h>
+#include <string.h>
+
+#define PI 3.14159265358979323846f
+
+uint32_t od_decimator_factor(uint32_t sample_rate, uint32_t min_rate) {
+    if (min_rate == 0 || sample_rate < 2 * min_rate) return 1;
+    uint32_t factor = sample_rate / min_rate;
+    if (factor > OD_DECIMATOR_MAX_FACTOR) factor = OD_DECIMATOR_MAX_FACTOR;
+    return factor;
+}
+
+void od_decimator_init(Decimator_t* dec, uint32_t factor) {
+    memset(dec, 0, sizeof(Decimator_t));
+    if (factor < 1) factor = 1;
+    if (factor > OD_DECIMATOR_MAX_FACTOR) factor = OD_DECIMATOR_MAX_FACTOR;
+    dec->factor = factor;
+    if (factor == 1) return;
+
+    /* Cut-off at 90% of the output Nyquist, normalised to the input rate. */
+    uint32_t taps = OD_DECIMATOR_TAPS_PER_PHASE * factor + 1;
+    float fc = 0.9f * 0.5f / (float)factor;
+    float mid = 0.5f * (float)(taps - 1);
+    float sum = 0.0f;
+
+    for (uint32_t i = 0; i < taps; i++) {
+        float t = (float)i - mid;
+        float sinc = (t == 0.0f) ? 2.0f * fc : sinf(2.0f * PI * fc * t) / (PI * t);
+        float w = 0.42f - 0.5f * cosf(2.0f * PI * (float)i / (float)(taps - 1))
+                        + 0.08f * cosf(4.0f * PI * (float)i / (float)(taps - 1));
+        dec->coeff[i] = sinc * w;
+        sum += dec->coeff[i];
+    }
+    for (uint32_t i = 0; i < taps; i++) dec->coeff[i] /= sum;   /* unity DC gain */
+    dec->taps = taps;
+}
+
+uint32_t od_decimator_run(const Decimator_t* dec, const float* in, uint32_t frames, uint32_t stride,
+                          uint32_t channels, float* out, uint32_t max_out) {
+    uint32_t factor = dec->factor;
+    uint32_t produced = frames / factor;
+    if (produced > max_out) produced = max_out;
+
+    if (factor == 1) {
+        for (uint32_t i = 0; i < produced; i++) {
+            memcpy(out + (size_t)i * channels, in + (size_t)i * stride, channels * sizeof(float));
+        }
+        return produced;
+    }
+
+    int32_t half = (int32_t)(dec->taps / 2);
+    for (uint32_t o = 0; o < produced; o++) {
+        int32_t centre = (int32_t)(o * factor);
+        int32_t lo = centre - half, hi = centre + half;
+        if (lo < 0) lo = 0;
+        if (hi > (int32_t)frames - 1) hi = (int32_t)frames - 1;
+
+        float* dst = out + (size_t)o * channels;
+        for (uint32_t c = 0; c < channels; c++) dst[c] = 0.0f;
+        for (int32_t s = lo; s <= hi; s++) {
+            float w = dec->coeff[s - centre + half];
+            const float* src = in + (size_t)s * stride;
+            for (uint32_t c = 0; c < channels; c++) dst[c] += w * src[c];
+        }
+    }
+    return produced;
+}
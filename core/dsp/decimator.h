@@ -0,0 +1,43 @@
+#ifndef OD_DECIMATOR_H
+#define OD_DECIMATOR_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "dsp_config.h"
+
+/* Integer-ratio decimator for high-rate sinks (88.2/96/176.4/192 kHz).
+ * A Blackman-windowed sinc low-pass is evaluated only at the kept
+ * output positions, so the cost is taps/factor MACs per input sample.
+ * Blocks are filtered independently (the capture path hands over the
+ * latest block, not a contiguous stream); the few output frames at each
+ * edge see a zero-padded history, which the analysis window tolerates. */
+
+#define OD_DECIMATOR_MAX_FACTOR 8
+#define OD_DECIMATOR_TAPS_PER_PHASE 8
+#define OD_DECIMATOR_MAX_TAPS (OD_DECIMATOR_TAPS_PER_PHASE * OD_DECIMATOR_MAX_FACTOR + 1)
+
+typedef struct {
+    uint32_t factor;                        /* 1 = pass-through */
+    uint32_t taps;
+    float coeff[OD_DECIMATOR_MAX_TAPS];
+} Decimator_t;
+
+/* Largest factor keeping the output rate >= min_rate, or 1 when
+ * min_rate is 0 or the stream is already slow enough. */
+uint32_t od_decimator_factor(uint32_t sample_rate, uint32_t min_rate);
+
+void od_decimator_init(Decimator_t* dec, uint32_t factor);
+
+/* Reads `frames` interleaved frames (`stride` floats apart) and writes
+ * at most `max_out` decimated frames of the first `channels` channels,
+ * packed `channels` apart.  Returns the number of frames written. */
+uint32_t od_decimator_run(const Decimator_t* dec, const float* in, uint32_t frames, uint32_t stride,
+                          uint32_t channels, float* out, uint32_t max_out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -6,6 +6,8 @@ extern "C" {
 #endif
 
 #include "../driver/capture.h"
+#include "../events/events.h"
+#include "dsp_config.h"
 
 
 typedef struct {
@@ -14,6 +16,7 @@ typedef struct {
     int signature_match_id;
     float confidence;
     int sound_type;      
+    float elevation_angle;  /* degrees above ear level, 0 without height channels */
 } SoundEntity_t;
 
 typedef struct {
@@ -21,14 +24,67 @@ typedef struct {
     int entity_count;
 } SpatialData_t;
 
+typedef struct DSPContext DSPContext_t;
 
+/* Receives the onset events a context detects (see events.h). */
+typedef void (*SoundEventSink_t)(const SoundEvent_t* event, void* user);
 
 
+void OD_DSP_DefaultConfig(DSPConfig_t* config);
+
+/* Parses "scale[:bands[:min_hz[:max_hz]]]", scale one of legacy/log/bark/erb. */
+int OD_DSP_ParseBandLayout(const char* spec, BandLayout_t* layout);
+
+/* Parses a named layout ("5.1", "7.1.4", "9.1.6", ...) or a comma list of
+ * positions ("FL,FR,FC,LFE,BL,BR,SL,SR,TFL,TFR,TBL,TBR"). */
+int OD_DSP_ParseChannelMap(const char* spec, ChannelMap_t* map);
+
+
+DSPContext_t* OD_DSP_CreateContext(const DSPConfig_t* config);
+
+
+void OD_DSP_DestroyContext(DSPContext_t* ctx);
+
+/* Swaps the band table and forgets the per-band history and label tracks
+ * built on the old one; must not race with OD_DSP_Process on the same context. */
+int OD_DSP_SetBandLayout(DSPContext_t* ctx, const BandLayout_t* layout);
+
+/* Replaces the label smoothing (see labels.h) and restarts its tracks;
+ * must not race with OD_DSP_Process on the same context. */
+int OD_DSP_SetLabelSmoothing(DSPContext_t* ctx, const LabelSmoothing_t* labels);
+
+/* A buffer with the same nonzero `sequence` as the last one processed is
+ * that capture block again: the last result comes back without rerunning
+ * anything, whatever sensitivity and separation are passed. */
+SpatialData_t OD_DSP_Process(DSPContext_t* ctx, const AudioBuffer_t* buffer, float sensitivity, float separation);
+
+/* Forgets the stream history (classifier transient, label tracks, onset
+ * tracks, stream clock, the last result) so the context can start on an
+ * unrelated stream. */
+void OD_DSP_ResetStream(DSPContext_t* ctx);
+
+/* Where the context's onset events go; by default every OD_Events
+ * subscriber.  NULL turns event detection off for the context. */
+void OD_DSP_SetEventSink(DSPContext_t* ctx, SoundEventSink_t sink, void* user);
+
+
+DSPContext_t* OD_DSP_GetDefaultContext(void);
+
+/* Processes on the default context. */
 SpatialData_t OD_DSP_ProcessBuffer(const AudioBuffer_t* buffer, float sensitivity, float separation);
 
 
+/* Adds the loud frames of a reference clip (any file OD_AudioFile opens)
+ * to signature `id` (>= 0) in the shared library; several clips may feed
+ * one id.  While the library is not empty, each entity reports the
+ * nearest signature in signature_match_id with a distance-based
+ * confidence, or -1 and its localisation confidence when none is close.
+ * Safe to call while contexts are processing.  Returns 0 on error. */
 int OD_DSP_LoadSignature(int id, const char* file_path);
 
+/* Empties the signature library; entities report their band again. */
+void OD_DSP_ClearSignatures(void);
+
 #ifdef __cplusplus
 }
 #endif
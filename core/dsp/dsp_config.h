@@ -0,0 +1,97 @@
+#ifndef OD_DSP_CONFIG_H
+#define OD_DSP_CONFIG_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+#define OD_MAX_BANDS 32
+#define OD_MAX_FFT_SIZE 2048
+#define OD_MAX_CHANNELS 16
+#define OD_MAX_SOUND_TYPES 16
+#define OD_MAX_LABEL_LAG 15
+
+/* ──────────────────── Channel positions ────────────────────
+ *
+ *  Speaker positions in the order a stream interleaves them.  Geometry
+ *  (azimuth/elevation) for each position lives in channel_layout.c.
+ */
+
+typedef enum {
+    CH_POS_UNKNOWN = 0,     /* not localised */
+    CH_POS_MONO,
+    CH_POS_FL, CH_POS_FR, CH_POS_FC, CH_POS_LFE,
+    CH_POS_BL, CH_POS_BR, CH_POS_SL, CH_POS_SR,
+    CH_POS_FLC, CH_POS_FRC, CH_POS_BC,
+    CH_POS_FLW, CH_POS_FRW,
+    CH_POS_TFL, CH_POS_TFR, CH_POS_TFC, CH_POS_TC,
+    CH_POS_TBL, CH_POS_TBR, CH_POS_TSL, CH_POS_TSR, CH_POS_TBC,
+    CH_POS_LFE2,
+    CH_POS_COUNT
+} ChannelPosition_t;
+
+typedef struct {
+    uint32_t channels;                      /* 0 = derive from the stream's channel count */
+    uint8_t position[OD_MAX_CHANNELS];      /* ChannelPosition_t per interleaved channel */
+} ChannelMap_t;
+
+/* ──────────────────── Band layout ────────────────────
+ *
+ *  Bands are specified in Hz on a perceptual or log scale and
+ *  turned into a sparse bin-weight table when a DSP context is
+ *  created.  BAND_SCALE_LEGACY keeps the edges of the original
+ *  four hard-coded bands (bins 1/6/21/85/256 of a 512 FFT at
+ *  48 kHz), not their readings: those summed a few strided bins
+ *  per band (one on Windows), where every layout now takes the
+ *  mean power of all the bins a band covers.  Band energies are
+ *  on that new scale, so a given sensitivity trips at different
+ *  levels than it did before.
+ */
+
+typedef enum {
+    BAND_SCALE_LEGACY = 0,
+    BAND_SCALE_LOG,
+    BAND_SCALE_BARK,
+    BAND_SCALE_ERB,
+    BAND_SCALE_COUNT
+} BandScale_t;
+
+typedef struct {
+    BandScale_t scale;
+    uint32_t num_bands;
+    float min_hz;
+    float max_hz;
+} BandLayout_t;
+
+/* ──────────────────── Label smoothing ────────────────────
+ *
+ *  Sound types are decoded over time rather than picked per frame
+ *  (see labels.h).  Penalties are in natural-log units of the
+ *  classifier score; a type may only be left once it has lasted
+ *  min_frames.  Indexed by SoundType_t.
+ */
+
+typedef struct {
+    int enabled;
+    uint32_t lag;                                           /* frames a label waits for, <= OD_MAX_LABEL_LAG */
+    float penalty[OD_MAX_SOUND_TYPES][OD_MAX_SOUND_TYPES];  /* [from][to], the diagonal unused */
+    uint16_t min_frames[OD_MAX_SOUND_TYPES];
+} LabelSmoothing_t;
+
+typedef struct {
+    uint32_t fft_size;      /* power of two, <= OD_MAX_FFT_SIZE */
+    uint32_t sample_rate;   /* expected stream rate; followed if capture reports another */
+    uint32_t min_analysis_rate; /* decimate faster streams by an integer ratio down to >= this; 0 = off */
+    uint32_t channels;      /* expected stream channels, 0 = unknown */
+    ChannelMap_t channel_map;
+    BandLayout_t bands;
+    LabelSmoothing_t labels;
+} DSPConfig_t;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,786 @@
+#ifdef _WIN32
+#include "dsp_windows.h"
+#include "classifier_windows.h"
+#else
+#include "dsp.h"
+#include "classifier.h"
+#endif
+#include "dsp_engine.h"
+#include "channel_layout.h"
+#include "signature.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#define PI 3.14159265358979323846f
+
+/* ──────────────────── Configuration ──────────────────── */
+
+void OD_DSP_DefaultConfig(DSPConfig_t* config) {
+    if (!config) return;
+    memset(config, 0, sizeof(DSPConfig_t));
+    config->fft_size = 512;
+    config->sample_rate = 48000;
+    config->bands.scale = BAND_SCALE_LEGACY;
+    config->bands.num_bands = 4;
+    od_labels_default(&config->labels);
+}
+
+int OD_DSP_ParseBandLayout(const char* spec, BandLayout_t* layout) {
+    if (!spec || !layout) return 0;
+
+    BandLayout_t out;
+    memset(&out, 0, sizeof(out));
+
+    char name[16] = {0};
+    unsigned int count = 0;
+    float lo = 0.0f, hi = 0.0f;
+    int fields = sscanf(spec, "%15[a-z]:%u:%f:%f", name, &count, &lo, &hi);
+    if (fields < 1) return 0;
+
+    if (strcmp(name, "legacy") == 0) out.scale = BAND_SCALE_LEGACY;
+    else if (strcmp(name, "log") == 0) out.scale = BAND_SCALE_LOG;
+    else if (strcmp(name, "bark") == 0) out.scale = BAND_SCALE_BARK;
+    else if (strcmp(name, "erb") == 0) out.scale = BAND_SCALE_ERB;
+    else return 0;
+
+    out.num_bands = (fields >= 2) ? count : 8;
+    out.min_hz = (fields >= 3) ? lo : 0.0f;
+    out.max_hz = (fields >= 4) ? hi : 0.0f;
+    if (out.scale != BAND_SCALE_LEGACY && (out.num_bands < 1 || out.num_bands > OD_MAX_BANDS)) return 0;
+
+    *layout = out;
+    return 1;
+}
+
+static const struct {
+    const char* name;
+    uint32_t channels;
+} named_layouts[] = {
+    { "mono", 1 }, { "2.0", 2 }, { "2.1", 3 }, { "quad", 4 }, { "5.0", 5 },
+    { "5.1", 6 }, { "6.1", 7 }, { "7.1", 8 }, { "7.1.2", 10 }, { "7.1.4", 12 },
+    { "9.1.4", 14 }, { "9.1.6", 16 },
+};
+
+int OD_DSP_ParseChannelMap(const char* spec, ChannelMap_t* map) {
+    if (!spec || !map) return 0;
+
+    for (size_t i = 0; i < sizeof(named_layouts) / sizeof(named_layouts[0]); i++) {
+        if (strcmp(spec, named_layouts[i].name) == 0) {
+            od_channel_map_default(named_layouts[i].channels, map);
+            return 1;
+        }
+    }
+
+    /* Explicit list: "FL,FR,FC,LFE,BL,BR,SL,SR,TFL,TFR,TBL,TBR" */
+    ChannelMap_t out;
+    memset(&out, 0, sizeof(out));
+    const char* p = spec;
+    while (*p && out.channels < OD_MAX_CHANNELS) {
+        size_t len = strcspn(p, ",");
+        uint32_t pos = CH_POS_COUNT;
+        for (uint32_t k = 0; k < CH_POS_COUNT; k++) {
+            const char* name = od_channel_position_name(k);
+            if (strlen(name) == len && strncmp(p, name, len) == 0) { pos = k; break; }
+        }
+        if (pos == CH_POS_COUNT) return 0;
+        out.position[out.channels++] = (uint8_t)pos;
+        p += len;
+        if (*p == ',') p++;
+    }
+    if (out.channels == 0 || *p) return 0;
+
+    *map = out;
+    return 1;
+}
+
+static void free_plan(DSPContext_t* ctx) {
+    od_fft_free(&ctx->fft);
+    od_filterbank_free(&ctx->bands);
+    od_mfcc_free(&ctx->mfcc);
+    free(ctx->left);
+    free(ctx->right);
+    free(ctx->planes);
+    free(ctx->power);
+    free(ctx->decimated);
+    free(ctx->spectrum.re);
+    free(ctx->spectrum.im);
+    free(ctx->spectrum.mono);
+    ctx->left = ctx->right = ctx->planes = ctx->power = ctx->decimated = NULL;
+    ctx->spectrum.re = ctx->spectrum.im = ctx->spectrum.mono = NULL;
+}
+
+/* Derives angle/elevation tables, downmix matrix and steering vectors
+ * from `map`.  Standard 2.0/5.1/7.1 maps also get the specialised kernels. */
+static void apply_channel_layout(DSPContext_t* ctx, const ChannelMap_t* map) {
+    ChannelMap_t standard;
+    od_channel_map_default(map->channels, &standard);
+
+    ctx->map = *map;
+    od_channel_geometry_build(map, &ctx->geom);
+    ctx->kernels = od_channel_map_equal(map, &standard)
+                 ? od_dsp_find_kernels(map->channels, ctx->config.fft_size) : NULL;
+}
+
+/* Map for a stream of `channels`: the configured map when it matches,
+ * then the positions reported by capture, then the standard map. */
+static void resolve_channel_map(const DSPContext_t* ctx, uint32_t channels, const uint8_t* position,
+                                ChannelMap_t* map) {
+    if (ctx->config.channel_map.channels == channels) {
+        *map = ctx->config.channel_map;
+        return;
+    }
+
+    int positioned = 0;
+    for (uint32_t c = 0; position && c < channels; c++) {
+        if (position[c] != CH_POS_UNKNOWN) positioned = 1;
+    }
+    if (!positioned) {
+        od_channel_map_default(channels, map);
+        return;
+    }
+
+    memset(map, 0, sizeof(ChannelMap_t));
+    map->channels = channels;
+    for (uint32_t c = 0; c < channels; c++) {
+        map->position[c] = position[c] < CH_POS_COUNT ? position[c] : CH_POS_UNKNOWN;
+    }
+}
+
+/* Builds the band table and decimator for a stream at `rate`.  Bands are
+ * specified in Hz, so they keep their meaning at any rate; the decimation
+ * scratch is allocated once and kept.  Leaves the plan untouched on failure. */
+static int apply_sample_rate(DSPContext_t* ctx, uint32_t rate) {
+    uint32_t factor = od_decimator_factor(rate, ctx->config.min_analysis_rate);
+    uint32_t analysis_rate = rate / factor;
+
+    if (factor > 1 && !ctx->decimated) {
+        ctx->decimated = (float*)calloc((size_t)OD_MAX_CHANNELS * ctx->config.fft_size, sizeof(float));
+        if (!ctx->decimated) return 0;
+    }
+
+    Filterbank_t fb;
+    if (!od_filterbank_build(&fb, &ctx->config.bands, ctx->config.fft_size, analysis_rate)) return 0;
+    if (!od_mfcc_build(&ctx->mfcc, ctx->config.fft_size, analysis_rate)) {
+        od_filterbank_free(&fb);
+        return 0;
+    }
+
+    od_filterbank_free(&ctx->bands);
+    ctx->bands = fb;
+    od_decimator_init(&ctx->decim, factor);
+    ctx->analysis_rate = analysis_rate;
+    ctx->config.sample_rate = rate;
+    return 1;
+}
+
+/* Follows a change in the negotiated capture format: rebuilds the band
+ * table when the sample rate moved and the geometry when the layout did.
+ * On allocation failure the previous band table is kept. */
+static void update_stream_format(DSPContext_t* ctx, const AudioBuffer_t* buffer, uint32_t channels) {
+    uint32_t rate = buffer->sample_rate;
+    if (rate > 0 && rate != ctx->config.sample_rate) {
+        if (!apply_sample_rate(ctx, rate)) {
+            printf("[DSP] Could not rebuild bands for %u Hz, keeping %u Hz\n", rate, ctx->config.sample_rate);
+        }
+    }
+
+    ChannelMap_t map;
+    resolve_channel_map(ctx, channels, buffer->position, &map);
+    if (map.channels != ctx->geom.channels || !od_channel_map_equal(&map, &ctx->map)) {
+        apply_channel_layout(ctx, &map);
+    }
+
+    ctx->format_serial = buffer->format_serial;
+}
+
+static int build_plan(DSPContext_t* ctx, const DSPConfig_t* config) {
+    uint32_t n = config->fft_size;
+    if (n < 64 || n > OD_MAX_FFT_SIZE || (n & (n - 1)) != 0) return 0;
+    if (config->labels.lag > OD_MAX_LABEL_LAG) return 0;
+
+    ctx->config = *config;
+    if (!od_fft_init(&ctx->fft, n)) return 0;
+    if (!apply_sample_rate(ctx, config->sample_rate)) {
+        free_plan(ctx);
+        return 0;
+    }
+
+    ctx->left   = (float*)calloc(n, sizeof(float));
+    ctx->right  = (float*)calloc(n, sizeof(float));
+    ctx->planes = (float*)calloc((size_t)OD_MAX_CHANNELS * n, sizeof(float));
+    ctx->power  = (float*)calloc(n / 2 + 1, sizeof(float));
+    ctx->spectrum.bins = n / 2 + 1;
+    ctx->spectrum.re   = (float*)calloc((size_t)OD_MAX_CHANNELS * ctx->spectrum.bins, sizeof(float));
+    ctx->spectrum.im   = (float*)calloc((size_t)OD_MAX_CHANNELS * ctx->spectrum.bins, sizeof(float));
+    ctx->spectrum.mono = (float*)calloc(ctx->spectrum.bins, sizeof(float));
+    if (!ctx->left || !ctx->right || !ctx->planes || !ctx->power ||
+        !ctx->spectrum.re || !ctx->spectrum.im || !ctx->spectrum.mono) {
+        free_plan(ctx);
+        return 0;
+    }
+
+    if (config->channel_map.channels > 0) {
+        apply_channel_layout(ctx, &config->channel_map);
+    } else if (config->channels > 0) {
+        ChannelMap_t map;
+        od_channel_map_default(config->channels, &map);
+        apply_channel_layout(ctx, &map);
+    }
+    /* Logged once here; layouts followed from the stream are rebuilt on
+     * the analysis thread and stay quiet. */
+    if (ctx->geom.channels > 0) {
+        printf("[DSP] Layout: %u ch, %u directional%s, %s kernels\n",
+               ctx->geom.channels, ctx->geom.dir_count, ctx->geom.has_height ? " (with height)" : "",
+               ctx->kernels ? ctx->kernels->name : "generic");
+    }
+    return 1;
+}
+
+/* Default event sink: every OD_Events subscriber. */
+static void publish_event(const SoundEvent_t* event, void* user) {
+    (void)user;
+    od_events_publish(event);
+}
+
+DSPContext_t* OD_DSP_CreateContext(const DSPConfig_t* config) {
+    DSPConfig_t defaults;
+    if (!config) {
+        OD_DSP_DefaultConfig(&defaults);
+        config = &defaults;
+    }
+
+    DSPContext_t* ctx = (DSPContext_t*)calloc(1, sizeof(DSPContext_t));
+    if (!ctx) return NULL;
+    od_onset_reset(&ctx->onsets);
+    ctx->event_sink = publish_event;
+    if (!build_plan(ctx, config)) {
+        printf("[DSP] Invalid configuration (fft=%u, rate=%u, scale=%d, bands=%u)\n",
+               config->fft_size, config->sample_rate, (int)config->bands.scale, config->bands.num_bands);
+        free(ctx);
+        return NULL;
+    }
+    return ctx;
+}
+
+void OD_DSP_DestroyContext(DSPContext_t* ctx) {
+    if (!ctx) return;
+    free_plan(ctx);
+    free(ctx);
+}
+
+int OD_DSP_SetBandLayout(DSPContext_t* ctx, const BandLayout_t* layout) {
+    if (!ctx || !layout) return 0;
+
+    Filterbank_t fb;
+    if (!od_filterbank_build(&fb, layout, ctx->config.fft_size, ctx->analysis_rate)) return 0;
+
+    od_filterbank_free(&ctx->bands);
+    ctx->bands = fb;
+    ctx->config.bands = *layout;
+
+    /* Per-band state is indexed by the old bands, and so is the cached result. */
+    memset(ctx->band_history, 0, sizeof(ctx->band_history));
+    for (uint32_t b = 0; b < OD_MAX_BANDS; b++) od_labels_reset(&ctx->band_labels[b]);
+    ctx->last_sequence = 0;
+    return 1;
+}
+
+int OD_DSP_SetLabelSmoothing(DSPContext_t* ctx, const LabelSmoothing_t* labels) {
+    if (!ctx || !labels || labels->lag > OD_MAX_LABEL_LAG) return 0;
+    ctx->config.labels = *labels;
+    od_labels_reset(&ctx->frame_labels);
+    for (uint32_t b = 0; b < OD_MAX_BANDS; b++) od_labels_reset(&ctx->band_labels[b]);
+    return 1;
+}
+
+/* ──────────────────── Entity helpers ──────────────────── */
+
+static float distance_from_energy(float avg) {
+    float distance = 1.0f / (1.0f + sqrtf(avg) * 15.0f);
+    if (distance < 0.1f) distance = 0.1f;
+    if (distance > 0.95f) distance = 0.95f;
+    return distance;
+}
+
+/* Append an entity, or fold it into an existing one closer than `separation`
+ * degrees.  Returns the index it ended up in. */
+static int push_entity(SpatialData_t* result, const SoundEntity_t* entity, float separation) {
+    for (int e = 0; e < result->entity_count; e++) {
+        float diff = result->entities[e].azimuth_angle - entity->azimuth_angle;
+        if (diff > 180.0f) diff -= 360.0f;
+        if (diff < -180.0f) diff += 360.0f;
+
+        if (fabsf(diff) < separation) {
+            result->entities[e].azimuth_angle = (result->entities[e].azimuth_angle + entity->azimuth_angle) * 0.5f;
+            result->entities[e].elevation_angle = (result->entities[e].elevation_angle + entity->elevation_angle) * 0.5f;
+            if (entity->distance < result->entities[e].distance)
+                result->entities[e].distance = entity->distance;
+            return e;
+        }
+    }
+    result->entities[result->entity_count] = *entity;
+    return result->entity_count++;
+}
+
+/* ──────────────────── Generic kernels ────────────────────
+ *
+ *  Used for layouts / FFT sizes without a specialisation in
+ *  dsp_kernels.cpp.  Driven by the context's channel geometry.
+ */
+
+static void generic_downmix(const ChannelGeometry_t* g, const float* in, uint32_t n, uint32_t stride,
+                            float* left, float* right) {
+    for (uint32_t i = 0; i < n; i++) {
+        const float* frame = in + (size_t)i * stride;
+        float l = 0.0f, r = 0.0f;
+        for (uint32_t d = 0; d < g->dir_count; d++) {
+            uint32_t c = g->dir_index[d];
+            l += frame[c] * g->mix_l[c];
+            r += frame[c] * g->mix_r[c];
+        }
+        left[i] = l;
+        right[i] = r;
+    }
+}
+
+/* Spectrum of one signal into cache slot `slot`, and its band energies. */
+static void channel_spectrum(DSPContext_t* ctx, const float* signal, uint32_t n, uint32_t slot) {
+    SpectrumCache_t* s = &ctx->spectrum;
+    float* re = s->re + (size_t)slot * s->bins;
+    float* im = s->im + (size_t)slot * s->bins;
+    od_fft_spectrum(&ctx->fft, signal, n, re, im);
+
+    float norm = 1.0f / (float)n;
+    for (uint32_t k = 0; k < s->bins; k++) ctx->power[k] = (re[k] * re[k] + im[k] * im[k]) * norm;
+    od_filterbank_apply(&ctx->bands, ctx->power, ctx->band_energy[slot]);
+}
+
+static void generic_channel_bands(DSPContext_t* ctx, const float* in, uint32_t n, uint32_t stride) {
+    const ChannelGeometry_t* g = &ctx->geom;
+    for (uint32_t d = 0; d < g->dir_count; d++) {
+        uint32_t c = g->dir_index[d];
+        float* plane = ctx->planes + (size_t)c * ctx->config.fft_size;
+        for (uint32_t i = 0; i < n; i++) {
+            plane[i] = in[(size_t)i * stride + c];
+        }
+        channel_spectrum(ctx, plane, n, c);
+    }
+}
+
+/* Power spectrum of the classifier's mono signal, (left + right) / 2,
+ * mixed from the cached channel spectra with the downmix weights.  Front
+ * layouts cache the left/right signals themselves in slots 0 and 1. */
+static void mono_spectrum(DSPContext_t* ctx, uint32_t n) {
+    const ChannelGeometry_t* g = &ctx->geom;
+    SpectrumCache_t* s = &ctx->spectrum;
+    uint32_t count = g->pans ? 2 : g->dir_count;
+    float weight[OD_MAX_CHANNELS];
+    const float* re[OD_MAX_CHANNELS];
+    const float* im[OD_MAX_CHANNELS];
+    for (uint32_t d = 0; d < count; d++) {
+        uint32_t c = g->pans ? d : g->dir_index[d];
+        weight[d] = g->pans ? 0.5f : 0.5f * (g->mix_l[c] + g->mix_r[c]);
+        re[d] = s->re + (size_t)c * s->bins;
+        im[d] = s->im + (size_t)c * s->bins;
+    }
+
+    float norm = 1.0f / (float)n;
+    for (uint32_t k = 0; k < s->bins; k++) {
+        float xr = 0.0f, xi = 0.0f;
+        for (uint32_t d = 0; d < count; d++) {
+            xr += weight[d] * re[d][k];
+            xi += weight[d] * im[d][k];
+        }
+        s->mono[k] = (xr * xr + xi * xi) * norm;
+    }
+}
+
+static void generic_steer(const DSPContext_t* ctx, float* vx, float* vy, float* vz, float* total) {
+    const ChannelGeometry_t* g = &ctx->geom;
+    for (uint32_t band = 0; band < ctx->bands.num_bands; band++) {
+        float x = 0.0f, y = 0.0f, z = 0.0f, t = 0.0f;
+        for (uint32_t d = 0; d < g->dir_count; d++) {
+            uint32_t c = g->dir_index[d];
+            float e = ctx->band_energy[c][band];
+            x += g->vec_x[c] * e;
+            y += g->vec_y[c] * e;
+            z += g->vec_z[c] * e;
+            t += e;
+        }
+        vx[band] = x;
+        vy[band] = y;
+        vz[band] = z;
+        total[band] = t;
+    }
+}
+
+/* ──────────────────── Per-entity classification ────────────────────
+ *
+ *  Each entity is classified from its own bands: the channel spectra are
+ *  mixed coherently with weights steered toward its direction, over just
+ *  the bins of the bands it was built from.  Per-band feature history
+ *  carries its transient from frame to frame.  With signatures loaded,
+ *  the steered spectrum is also looked up in the library, and the frame's
+ *  spectral peaks are fingerprinted.
+ */
+
+/* Mix weights per cache slot toward (azimuth, elevation); returns the slot count. */
+static uint32_t steer_weights(const DSPContext_t* ctx, const SoundEntity_t* entity, uint32_t* slot, float* weight) {
+    const ChannelGeometry_t* g = &ctx->geom;
+    if (g->pans) {
+        float az = entity->azimuth_angle > 180.0f ? entity->azimuth_angle - 360.0f : entity->azimuth_angle;
+        float pan = az / 90.0f;
+        if (pan < -1.0f) pan = -1.0f;
+        if (pan > 1.0f) pan = 1.0f;
+        slot[0] = 0;
+        slot[1] = 1;
+        weight[0] = 0.5f * (1.0f - pan);
+        weight[1] = 0.5f * (1.0f + pan);
+        return 2;
+    }
+
+    float az = entity->azimuth_angle * PI / 180.0f, el = entity->elevation_angle * PI / 180.0f;
+    float ux = sinf(az) * cosf(el), uy = cosf(az) * cosf(el), uz = sinf(el);
+    float sum = 0.0f;
+    for (uint32_t d = 0; d < g->dir_count; d++) {
+        uint32_t c = g->dir_index[d];
+        float w = g->vec_x[c] * ux + g->vec_y[c] * uy + g->vec_z[c] * uz;
+        slot[d] = c;
+        weight[d] = w > 0.0f ? w : 0.0f;
+        sum += weight[d];
+    }
+    for (uint32_t d = 0; d < g->dir_count; d++) {
+        weight[d] = sum > 0.0f ? weight[d] / sum : 1.0f / (float)g->dir_count;
+    }
+    return g->dir_count;
+}
+
+/* Looks up the whole steered spectrum, not just the entity's bands: a
+ * sound often loses some of its bands to a neighbouring entity, and the
+ * reference clips were analysed full-band. */
+static void match_signature(const DSPContext_t* ctx, SoundEntity_t* entity, const uint32_t* slot,
+                            const float* weight, uint32_t count, uint32_t n) {
+    const SpectrumCache_t* s = &ctx->spectrum;
+    float power[OD_MAX_FFT_SIZE / 2 + 1];
+    for (uint32_t k = 0; k < s->bins; k++) {
+        float xr = 0.0f, xi = 0.0f;
+        for (uint32_t d = 0; d < count; d++) {
+            xr += weight[d] * s->re[(size_t)slot[d] * s->bins + k];
+            xi += weight[d] * s->im[(size_t)slot[d] * s->bins + k];
+        }
+        power[k] = (xr * xr + xi * xi) / (float)n;
+    }
+
+    float v[OD_SIGNATURE_DIMS];
+    SignatureMatch_t match;
+    od_signature_vector(&ctx->mfcc, power, v);
+    if (od_signature_match(v, &match)) {
+        entity->signature_match_id = match.id;
+        entity->confidence = match.confidence;
+    } else {
+        entity->signature_match_id = -1;
+    }
+}
+
+/* Landmarks of the frame's downmix spectrum.  Each peak that completes a
+ * fingerprint match names the entity whose bands hold it; an exact match
+ * outranks the nearest-shape one. */
+static void match_fingerprints(DSPContext_t* ctx, SpatialData_t* result, const uint32_t* band_mask) {
+    const Filterbank_t* fb = &ctx->bands;
+    FingerprintPeak_t peaks[OD_FP_PEAKS];
+    FingerprintHit_t hit[OD_FP_PEAKS];
+    float bin_hz = (float)ctx->analysis_rate / (float)ctx->config.fft_size;
+    uint32_t count = od_fp_peaks(ctx->spectrum.mono, ctx->spectrum.bins, bin_hz, peaks);
+    uint32_t tick = (uint32_t)(ctx->stream_us / OD_FP_TICK_US);
+    if (!od_signature_fingerprint(&ctx->fingerprint, peaks, count, tick, hit)) return;
+
+    uint32_t best[10] = { 0 };
+    for (uint32_t t = 0; t < count; t++) {
+        if (hit[t].id < 0) continue;
+        float hz = (float)peaks[t].bin * bin_hz;
+        uint32_t b = 0;
+        while (b < fb->num_bands && !(hz >= fb->edge_hz[b] && hz < fb->edge_hz[b + 1])) b++;
+        for (int e = 0; b < fb->num_bands && e < result->entity_count; e++) {
+            if (!(band_mask[e] & (1u << b)) || hit[t].votes <= best[e]) continue;
+            float confidence = (float)hit[t].votes / (2.0f * OD_FP_MIN_VOTES);
+            best[e] = hit[t].votes;
+            result->entities[e].signature_match_id = hit[t].id;
+            result->entities[e].confidence = confidence > 1.0f ? 1.0f : confidence;
+        }
+    }
+}
+
+/* The classifier's verdict on one frame of `track`, decoded over time when
+ * label smoothing is on. */
+static ClassResult_t classify(const DSPContext_t* ctx, LabelTrack_t* track, const SpectralFeatures_t* features,
+                              const float* mfcc) {
+    if (!ctx->config.labels.enabled) return OD_Classifier_ClassifyFrame(features, mfcc);
+
+    float scores[SOUND_TYPE_COUNT];
+    ClassResult_t result = OD_Classifier_ScoreFrame(features, mfcc, scores);
+    SoundType_t type = od_labels_step(track, &ctx->config.labels, scores);
+    if (type != result.type) {
+        result.type = type;
+        result.confidence = type == SOUND_UNKNOWN ? 0.0f : scores[type];
+    }
+    return result;
+}
+
+static void classify_entities(DSPContext_t* ctx, SpatialData_t* result, const uint32_t* band_mask, uint32_t n,
+                              ClassResult_t frame_class, const float* mfcc) {
+    const SpectrumCache_t* s = &ctx->spectrum;
+    const Filterbank_t* fb = &ctx->bands;
+    uint32_t seen = 0;
+    int signatures = od_signature_count() > 0;
+    int loudest = -1;
+    for (int e = 0; e < result->entity_count; e++) {
+        if (loudest < 0 || result->entities[e].distance < result->entities[loudest].distance) loudest = e;
+    }
+
+    for (int e = 0; e < result->entity_count; e++) {
+        SoundEntity_t* entity = &result->entities[e];
+        uint32_t slot[OD_MAX_CHANNELS];
+        float weight[OD_MAX_CHANNELS];
+        uint32_t count = steer_weights(ctx, entity, slot, weight);
+
+        /* The entity's bins, ascending; neighbouring bands may share an edge bin. */
+        uint16_t bins[OD_MAX_FFT_SIZE / 2 + 1];
+        float power[OD_MAX_FFT_SIZE / 2 + 1];
+        uint32_t region = 0;
+        int first_band = -1;
+        for (uint32_t b = 0; b < fb->num_bands; b++) {
+            if (!(band_mask[e] & (1u << b))) continue;
+            if (first_band < 0) first_band = (int)b;
+            for (uint32_t i = fb->row_start[b]; i < fb->row_start[b + 1]; i++) {
+                uint16_t k = fb->bin[i];
+                if (region > 0 && bins[region - 1] >= k) continue;
+                float xr = 0.0f, xi = 0.0f;
+                for (uint32_t d = 0; d < count; d++) {
+                    xr += weight[d] * s->re[(size_t)slot[d] * s->bins + k];
+                    xi += weight[d] * s->im[(size_t)slot[d] * s->bins + k];
+                }
+                bins[region] = k;
+                power[region] = (xr * xr + xi * xi) / (float)n;
+                region++;
+            }
+        }
+        if (first_band < 0) continue;
+
+        SpectralFeatures_t history = ctx->band_history[first_band];
+        SpectralFeatures_t features = OD_Classifier_FeaturesFromBins(power, bins, region, n, ctx->config.fft_size,
+                                                                     ctx->analysis_rate, &history);
+        for (uint32_t b = 0; b < fb->num_bands; b++) {
+            if (band_mask[e] & (1u << b)) ctx->band_history[b] = features;
+        }
+        seen |= band_mask[e];
+        if (signatures) match_signature(ctx, entity, slot, weight, count, n);
+        if (!mfcc && OD_Classifier_NeedsMFCC(&features)) mfcc = od_mfcc_catch_up(&ctx->mfcc);
+
+        /* The label track follows the entity's lowest band; a band that
+         * moves to another entity starts that one afresh rather than handing
+         * over a label that was never its own.  Rules tuned on the whole mix
+         * can miss a sound split over several entities, so the loudest one
+         * keeps the frame's label when its own is unknown. */
+        ClassResult_t own = classify(ctx, &ctx->band_labels[first_band], &features, mfcc);
+        for (uint32_t b = first_band + 1; b < fb->num_bands; b++) {
+            if ((band_mask[e] & (1u << b)) && ctx->band_labels[b].frames) od_labels_reset(&ctx->band_labels[b]);
+        }
+        entity->sound_type = (own.type == SOUND_UNKNOWN && e == loudest) ? frame_class.type : own.type;
+    }
+
+    for (uint32_t b = 0; b < fb->num_bands; b++) {
+        if (seen & (1u << b)) continue;
+        ctx->band_history[b].energy = 0.0f;
+        if (ctx->band_labels[b].frames) od_labels_reset(&ctx->band_labels[b]);
+    }
+    if (signatures) match_fingerprints(ctx, result, band_mask);
+}
+
+/* ──────────────────── Main DSP entry ──────────────────── */
+
+static SpatialData_t localise(DSPContext_t* ctx, const AudioBuffer_t* buffer, float sensitivity, float separation) {
+    SpatialData_t result;
+    memset(&result, 0, sizeof(SpatialData_t));
+
+    /* Below the capture silence gate: nothing to localise, skip it all. */
+    if (buffer->gated) return result;
+
+    /* Streams wider than OD_MAX_CHANNELS keep their real stride but
+     * only the first OD_MAX_CHANNELS channels are analysed. */
+    uint32_t stride = buffer->channels;
+    uint32_t ch = stride > OD_MAX_CHANNELS ? OD_MAX_CHANNELS : stride;
+    const float* in = buffer->buffer;
+
+    if (ch != ctx->geom.channels || buffer->format_serial != ctx->format_serial) {
+        update_stream_format(ctx, buffer, ch);
+    }
+
+    uint32_t n = buffer->num_samples;
+    if (ctx->decim.factor > 1) {
+        /* High-rate sink: analyse a decimated copy, packed ch apart. */
+        n = od_decimator_run(&ctx->decim, in, n, stride, ch, ctx->decimated, ctx->config.fft_size);
+        in = ctx->decimated;
+        stride = ch;
+        if (n == 0) return result;
+    }
+    if (n > ctx->config.fft_size) n = ctx->config.fft_size;
+    const ChannelGeometry_t* g = &ctx->geom;
+    const DSPKernels_t* k = ctx->kernels;
+    uint32_t num_bands = ctx->bands.num_bands;
+
+    /* ── Stereo downmix for classifier ── */
+    if (k) k->downmix(in, n, ctx->left, ctx->right);
+    else generic_downmix(g, in, n, stride, ctx->left, ctx->right);
+
+    /* ── One transform per analysed channel, shared with the classifier ── */
+    SpectrumCache_t* spec = &ctx->spectrum;
+    if (k) {
+        k->channel_bands(in, n, &ctx->bands, ctx->planes, spec->re, spec->im, ctx->band_energy);
+    } else if (!g->pans) {
+        generic_channel_bands(ctx, in, n, stride);
+    } else {
+        channel_spectrum(ctx, ctx->left, n, 0);
+        channel_spectrum(ctx, ctx->right, n, 1);
+    }
+    mono_spectrum(ctx, n);
+
+    SpectralFeatures_t features = OD_Classifier_FeaturesFromSpectrum(ctx->left, ctx->right, n, spec->mono,
+                                                                     ctx->config.fft_size, ctx->analysis_rate,
+                                                                     &ctx->prev_features);
+    /* The MFCCs cost more than the rest of the features together, so a
+     * frame the energy gate rejects only has its spectrum held; an entity
+     * loud enough to need them catches up below. */
+    const float* mfcc = NULL;
+    if (OD_Classifier_NeedsMFCC(&features)) mfcc = od_mfcc_update(&ctx->mfcc, spec->mono);
+    else if (OD_Classifier_WantsMFCC()) od_mfcc_hold(&ctx->mfcc, spec->mono);
+    else od_mfcc_reset(&ctx->mfcc);
+    ClassResult_t class_result = classify(ctx, &ctx->frame_labels, &features, mfcc);
+
+    if (sensitivity < 0.01f) return result;
+
+    float min_thresh = 0.00001f;
+    float max_thresh = 0.5f;
+    float threshold = max_thresh * powf(min_thresh / max_thresh, sensitivity);
+    uint32_t band_mask[10] = { 0 };             /* bands folded into each entity */
+
+    /* ────────────────────────────────────────────────────────
+     *  MULTI-CHANNEL SPATIAL PROCESSING
+     *
+     *  The band table has reduced each directional channel's
+     *  spectrum to per-band energies above.  Each band's
+     *  channel unit-vectors (3-D when the layout has height
+     *  speakers) are summed weighted by energy.
+     * ──────────────────────────────────────────────────────── */
+
+    if (!g->pans) {
+        float vx[OD_MAX_BANDS], vy[OD_MAX_BANDS], vz[OD_MAX_BANDS], total[OD_MAX_BANDS];
+
+        if (k) {
+            k->steer((const float (*)[OD_MAX_BANDS])ctx->band_energy, num_bands, vx, vy, total);
+            memset(vz, 0, sizeof(vz));
+        } else {
+            generic_steer(ctx, vx, vy, vz, total);
+        }
+
+        for (uint32_t band = 0; band < num_bands && result.entity_count < 10; band++) {
+            float total_energy = total[band];
+            if (total_energy < threshold) continue;
+
+            float azimuth = atan2f(vx[band], vy[band]) * 180.0f / PI;
+            if (azimuth < 0.0f) azimuth += 360.0f;
+            float horiz = sqrtf(vx[band] * vx[band] + vy[band] * vy[band]);
+            float elevation = atan2f(vz[band], horiz) * 180.0f / PI;
+
+            /* Confidence: magnitude of resultant vector / total energy */
+            float mag = sqrtf(horiz * horiz + vz[band] * vz[band]);
+            float confidence = (total_energy > 0.0f) ? (mag / total_energy) : 0.0f;
+            if (confidence > 1.0f) confidence = 1.0f;
+
+            SoundEntity_t entity;
+            entity.azimuth_angle = azimuth;
+            entity.distance = distance_from_energy(total_energy / (float)g->dir_count);
+            entity.confidence = confidence;
+            entity.signature_match_id = (int)band;
+            entity.sound_type = class_result.type;
+            entity.elevation_angle = elevation;
+            band_mask[push_entity(&result, &entity, separation)] |= 1u << band;
+        }
+        classify_entities(ctx, &result, band_mask, n, class_result, mfcc);
+        return result;
+    }
+
+    /* ── Front-only layouts: left/right pan per band ── */
+    const float* band_l = ctx->band_energy[0];
+    const float* band_r = ctx->band_energy[1];
+
+    for (uint32_t band = 0; band < num_bands && result.entity_count < 10; band++) {
+        float total = band_l[band] + band_r[band];
+        if (total < threshold) continue;
+
+        float pan = (total > 0.0f) ? (band_r[band] - band_l[band]) / total : 0.0f;
+        float azimuth = pan * 90.0f;
+        if (azimuth < 0) azimuth += 360.0f;
+
+        SoundEntity_t entity;
+        entity.azimuth_angle = azimuth;
+        entity.distance = distance_from_energy(total * 0.5f);
+        entity.confidence = fabsf(pan);
+        entity.signature_match_id = (int)band;
+        entity.sound_type = class_result.type;
+        entity.elevation_angle = 0.0f;
+        band_mask[push_entity(&result, &entity, separation)] |= 1u << band;
+    }
+
+    classify_entities(ctx, &result, band_mask, n, class_result, mfcc);
+    return result;
+}
+
+SpatialData_t OD_DSP_Process(DSPContext_t* ctx, const AudioBuffer_t* buffer, float sensitivity, float separation) {
+    SpatialData_t result;
+    memset(&result, 0, sizeof(SpatialData_t));
+
+    if (ctx == NULL || buffer == NULL || buffer->buffer == NULL || buffer->num_samples == 0 || buffer->channels < 1) {
+        return result;
+    }
+
+    /* A display polling faster than blocks arrive hands the same block in
+     * several times; it gets the first answer again, so the history the
+     * next block builds on (transient, label tracks, onsets, clock) moves
+     * once per block.  Unstamped buffers (sequence 0) always run. */
+    if (buffer->sequence && buffer->sequence == ctx->last_sequence) return ctx->last_result;
+
+    result = localise(ctx, buffer, sensitivity, separation);
+
+    /* Buffers without a capture time (files read directly) are stamped
+     * with the context's own stream clock. */
+    uint64_t now_us = buffer->timestamp_us ? buffer->timestamp_us : ctx->stream_us;
+    if (buffer->sample_rate) ctx->stream_us += (uint64_t)buffer->num_samples * 1000000u / buffer->sample_rate;
+    if (ctx->event_sink) od_onset_update(&ctx->onsets, &result, now_us, ctx->event_sink, ctx->event_user);
+    ctx->last_sequence = buffer->sequence;
+    ctx->last_result = result;
+    return result;
+}
+
+void OD_DSP_ResetStream(DSPContext_t* ctx) {
+    if (!ctx) return;
+    memset(&ctx->prev_features, 0, sizeof(ctx->prev_features));
+    memset(ctx->band_history, 0, sizeof(ctx->band_history));
+    od_mfcc_reset(&ctx->mfcc);
+    od_fp_reset(&ctx->fingerprint);
+    od_labels_reset(&ctx->frame_labels);
+    for (uint32_t b = 0; b < OD_MAX_BANDS; b++) od_labels_reset(&ctx->band_labels[b]);
+    od_onset_reset(&ctx->onsets);
+    ctx->stream_us = 0;
+    ctx->last_sequence = 0;
+}
+
+void OD_DSP_SetEventSink(DSPContext_t* ctx, SoundEventSink_t sink, void* user) {
+    if (!ctx) return;
+    ctx->event_sink = sink;
+    ctx->event_user = user;
+}
+
@@ -0,0 +1,66 @@
+#ifndef OD_DSP_ENGINE_H
+#define OD_DSP_ENGINE_H
+
+/* Internal layout of a DSP context, shared by the platform entry
+ * points (dsp.c / dsp_windows.c) and the engine implementation. */
+
+#include "dsp_config.h"
+#include "fft.h"
+#include "filterbank.h"
+#include "dsp_kernels.h"
+#include "channel_layout.h"
+#include "decimator.h"
+#include "onset.h"
+#include "mfcc.h"
+#include "fingerprint.h"
+#include "labels.h"
+#ifdef _WIN32
+#include "classifier_windows.h"
+#else
+#include "classifier.h"
+#endif
+
+/* Spectra of the current frame, computed once and shared by localisation
+ * and the classifier.  The classifier's mono downmix is a fixed linear mix
+ * of the channels, so its spectrum is mixed from theirs, not transformed. */
+typedef struct {
+    float* re;                      /* [OD_MAX_CHANNELS * bins] X[k] per analysed channel, unnormalised */
+    float* im;
+    float* mono;                    /* [bins] |X[k]|^2 / n of the classifier downmix */
+    uint32_t bins;                  /* fft_size / 2 + 1 */
+} SpectrumCache_t;
+
+struct DSPContext {
+    DSPConfig_t config;
+    FFTPlan_t fft;
+    Filterbank_t bands;             /* built for analysis_rate */
+    Decimator_t decim;
+    uint32_t analysis_rate;         /* config.sample_rate / decim.factor */
+    ChannelGeometry_t geom;         /* channels == 0 until the first layout is known */
+    ChannelMap_t map;               /* map geom was built from */
+    uint32_t format_serial;         /* AudioBuffer_t.format_serial the plan matches */
+    const DSPKernels_t* kernels;    /* NULL → generic loops */
+
+    float* left;            /* [fft_size] classifier downmix */
+    float* right;
+    float* planes;          /* [OD_MAX_CHANNELS * fft_size] de-interleaved channels */
+    float* decimated;       /* [OD_MAX_CHANNELS * fft_size] interleaved, only when decim.factor > 1 */
+    float* power;           /* [fft_size/2 + 1] */
+    float band_energy[OD_MAX_CHANNELS][OD_MAX_BANDS];
+    SpectrumCache_t spectrum;
+
+    SpectralFeatures_t prev_features;   /* classifier history */
+    SpectralFeatures_t band_history[OD_MAX_BANDS];  /* last features of the entity each band fed */
+    LabelTrack_t frame_labels;      /* sound type of the frame as a whole */
+    LabelTrack_t band_labels[OD_MAX_BANDS];         /* sound type of the entity each band fed */
+    MfccState_t mfcc;               /* built for analysis_rate; run only for frames the model reads it for */
+    FingerprintState_t fingerprint; /* run only while signatures are loaded */
+    OnsetTracker_t onsets;
+    uint64_t stream_us;             /* audio time processed so far */
+    uint32_t last_sequence;         /* AudioBuffer_t.sequence of last_result, 0 = none */
+    SpatialData_t last_result;
+    SoundEventSink_t event_sink;    /* NULL → no event detection */
+    void* event_user;
+};
+
+#endif
@@ -0,0 +1,279 @@
+#include "dsp_kernels.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+/* ──────────────────── Compile-time tables ────────────────────
+ *
+ *  Everything that depends only on the channel layout or the FFT
+ *  size (twiddles, bit reversal, angle unit-vectors, downmix weights)
+ *  is evaluated at compile time, so the kernels below run on constant
+ *  tables with compile-time trip counts.
+ */
+
+namespace {
+
+constexpr double kPi = 3.14159265358979323846;
+
+constexpr double cx_sin(double x) {
+    while (x > kPi) x -= 2.0 * kPi;
+    while (x < -kPi) x += 2.0 * kPi;
+    double term = x, sum = x;
+    for (int k = 1; k < 14; k++) {
+        term *= -x * x / (double)((2 * k) * (2 * k + 1));
+        sum += term;
+    }
+    return sum;
+}
+
+constexpr double cx_cos(double x) { return cx_sin(x + kPi / 2.0); }
+
+template <uint32_t N>
+struct FFTTables {
+    static constexpr uint32_t half = N / 2;
+
+    static constexpr std::array<uint32_t, half> make_bitrev() {
+        std::array<uint32_t, half> t{};
+        uint32_t bits = 0;
+        while ((1u << bits) < half) bits++;
+        for (uint32_t i = 0; i < half; i++) {
+            uint32_t r = 0;
+            for (uint32_t b = 0; b < bits; b++)
+                if (i & (1u << b)) r |= 1u << (bits - 1 - b);
+            t[i] = r;
+        }
+        return t;
+    }
+
+    static constexpr std::array<float, half> make_twiddle(bool imag) {
+        std::array<float, half> t{};
+        for (uint32_t j = 0; j < half / 2; j++) {
+            double a = -2.0 * kPi * (double)j / (double)half;
+            t[j] = (float)(imag ? cx_sin(a) : cx_cos(a));
+        }
+        return t;
+    }
+
+    static constexpr std::array<float, half + 1> make_split(bool imag) {
+        std::array<float, half + 1> t{};
+        for (uint32_t k = 0; k <= half; k++) {
+            double a = -2.0 * kPi * (double)k / (double)N;
+            t[k] = (float)(imag ? cx_sin(a) : cx_cos(a));
+        }
+        return t;
+    }
+
+    static constexpr auto bitrev = make_bitrev();
+    static constexpr auto tw_re = make_twiddle(false);
+    static constexpr auto tw_im = make_twiddle(true);
+    static constexpr auto split_re = make_split(false);
+    static constexpr auto split_im = make_split(true);
+};
+
+/* Same algorithm as od_fft_spectrum(), with N and every table fixed. */
+template <uint32_t N>
+void fft_spectrum(const float* in, uint32_t n, float* spec_re, float* spec_im) {
+    using T = FFTTables<N>;
+    constexpr uint32_t half = T::half;
+    float re[half], im[half];
+
+    for (uint32_t k = 0; k < half; k++) {
+        uint32_t i0 = 2 * k, i1 = 2 * k + 1;
+        re[T::bitrev[k]] = (i0 < n) ? in[i0] : 0.0f;
+        im[T::bitrev[k]] = (i1 < n) ? in[i1] : 0.0f;
+    }
+
+    for (uint32_t len = 2; len <= half; len <<= 1) {
+        const uint32_t hl = len >> 1;
+        const uint32_t step = half / len;
+        for (uint32_t base = 0; base < half; base += len) {
+            for (uint32_t j = 0; j < hl; j++) {
+                float wr = T::tw_re[j * step], wi = T::tw_im[j * step];
+                uint32_t a = base + j, b = a + hl;
+                float tr = re[b] * wr - im[b] * wi;
+                float ti = re[b] * wi + im[b] * wr;
+                re[b] = re[a] - tr;
+                im[b] = im[a] - ti;
+                re[a] += tr;
+                im[a] += ti;
+            }
+        }
+    }
+
+    for (uint32_t k = 0; k <= half; k++) {
+        uint32_t ka = (k == half) ? 0 : k;
+        uint32_t kb = (k == 0) ? 0 : half - k;
+        float zr = re[ka], zi = im[ka];
+        float cr = re[kb], ci = -im[kb];
+        float er = 0.5f * (zr + cr), ei = 0.5f * (zi + ci);
+        float o_r = 0.5f * (zi - ci), o_i = -0.5f * (zr - cr);
+        float wr = T::split_re[k], wi = T::split_im[k];
+        spec_re[k] = er + wr * o_r - wi * o_i;
+        spec_im[k] = ei + wr * o_i + wi * o_r;
+    }
+}
+
+/* ──────────────────── Channel layouts ──────────────────── */
+
+template <std::size_t C>
+struct LayoutTables {
+    std::array<bool, C> directional{};
+    std::array<float, C> sin_az{};
+    std::array<float, C> cos_az{};
+    std::array<float, C> mix_l{};
+    std::array<float, C> mix_r{};
+};
+
+/* Angles in degrees, negative = non-directional (LFE).  Mirrors the
+ * downmix rule in dsp_engine.c: sin < 0 feeds left, sin >= 0 feeds right,
+ * near-centre channels feed both at -3 dB. */
+template <std::size_t C>
+constexpr LayoutTables<C> make_layout(const std::array<float, C>& angle) {
+    LayoutTables<C> t{};
+    for (std::size_t c = 0; c < C; c++) {
+        if (angle[c] < 0.0f) continue;
+        double rad = (double)angle[c] * kPi / 180.0;
+        float s = (float)cx_sin(rad);
+        t.directional[c] = true;
+        t.sin_az[c] = s;
+        t.cos_az[c] = (float)cx_cos(rad);
+        if (s < 0.0f) t.mix_l[c] = -s;
+        else t.mix_r[c] = s;
+        if ((s < 0.0f ? -s : s) < 0.15f) {
+            t.mix_l[c] += 0.707f;
+            t.mix_r[c] += 0.707f;
+        }
+    }
+    return t;
+}
+
+struct Stereo20 {
+    static constexpr uint32_t channels = 2;
+    static constexpr bool pans = true;
+    static constexpr LayoutTables<2> tables{};
+};
+
+struct Surround51 {
+    static constexpr uint32_t channels = 6;
+    static constexpr bool pans = false;
+    static constexpr LayoutTables<6> tables = make_layout<6>({ 315.0f, 45.0f, 0.0f, -1.0f, 225.0f, 135.0f });
+};
+
+struct Surround71 {
+    static constexpr uint32_t channels = 8;
+    static constexpr bool pans = false;
+    static constexpr LayoutTables<8> tables = make_layout<8>({ 315.0f, 45.0f, 0.0f, -1.0f, 225.0f, 135.0f, 270.0f, 90.0f });
+};
+
+template <uint32_t C, class F>
+inline void for_each_channel(F&& f) {
+    [&]<std::size_t... I>(std::index_sequence<I...>) {
+        (f(std::integral_constant<std::size_t, I>{}), ...);
+    }(std::make_index_sequence<C>{});
+}
+
+/* ──────────────────── Kernels ──────────────────── */
+
+template <class L, uint32_t N>
+struct Kernels {
+    static constexpr uint32_t C = L::channels;
+
+    static void downmix(const float* in, uint32_t n, float* left, float* right) {
+        if constexpr (L::pans) {
+            for (uint32_t i = 0; i < n; i++) {
+                left[i]  = in[i * C + 0];
+                right[i] = in[i * C + 1];
+            }
+        } else {
+            for (uint32_t i = 0; i < n; i++) {
+                const float* frame = in + i * C;
+                float l = 0.0f, r = 0.0f;
+                for_each_channel<C>([&](auto c) {
+                    l += frame[c] * L::tables.mix_l[c];
+                    r += frame[c] * L::tables.mix_r[c];
+                });
+                left[i] = l;
+                right[i] = r;
+            }
+        }
+    }
+
+    static constexpr bool used(std::size_t c) {
+        if constexpr (L::pans) return true;
+        else return L::tables.directional[c];
+    }
+
+    static void channel_bands(const float* in, uint32_t n, const Filterbank_t* fb, float* planes,
+                              float* spec_re, float* spec_im, float band_energy[][OD_MAX_BANDS]) {
+        if (n > N) n = N;
+        for (uint32_t i = 0; i < n; i++) {
+            const float* frame = in + i * C;
+            for_each_channel<C>([&](auto c) {
+                if constexpr (used(c)) planes[c * N + i] = frame[c];
+            });
+        }
+
+        constexpr uint32_t bins = N / 2 + 1;
+        const float norm = 1.0f / (float)(n > 0 ? n : 1);
+        float power[bins];
+        for_each_channel<C>([&](auto c) {
+            if constexpr (used(c)) {
+                float* re = spec_re + c * bins;
+                float* im = spec_im + c * bins;
+                fft_spectrum<N>(planes + c * N, n, re, im);
+                for (uint32_t k = 0; k < bins; k++) power[k] = (re[k] * re[k] + im[k] * im[k]) * norm;
+                od_filterbank_apply(fb, power, band_energy[c]);
+            }
+        });
+    }
+
+    static void steer(const float band_energy[][OD_MAX_BANDS], uint32_t num_bands,
+                      float* vx, float* vy, float* total) {
+        for (uint32_t b = 0; b < num_bands; b++) {
+            float x = 0.0f, y = 0.0f, t = 0.0f;
+            for_each_channel<C>([&](auto c) {
+                if constexpr (used(c)) {
+                    float e = band_energy[c][b];
+                    x += L::tables.sin_az[c] * e;
+                    y += L::tables.cos_az[c] * e;
+                    t += e;
+                }
+            });
+            vx[b] = x;
+            vy[b] = y;
+            total[b] = t;
+        }
+    }
+};
+
+template <class L, uint32_t N>
+constexpr DSPKernels_t make_kernels(const char* name) {
+    return DSPKernels_t{
+        name, L::channels, N,
+        &Kernels<L, N>::downmix,
+        &Kernels<L, N>::channel_bands,
+        L::pans ? nullptr : &Kernels<L, N>::steer,
+    };
+}
+
+#define OD_KERNELS(layout, label, n) make_kernels<layout, n>(label "/" #n)
+
+const DSPKernels_t kernel_table[] = {
+    OD_KERNELS(Stereo20,   "2.0", 256), OD_KERNELS(Stereo20,   "2.0", 512),
+    OD_KERNELS(Stereo20,   "2.0", 1024), OD_KERNELS(Stereo20,  "2.0", 2048),
+    OD_KERNELS(Surround51, "5.1", 256), OD_KERNELS(Surround51, "5.1", 512),
+    OD_KERNELS(Surround51, "5.1", 1024), OD_KERNELS(Surround51, "5.1", 2048),
+    OD_KERNELS(Surround71, "7.1", 256), OD_KERNELS(Surround71, "7.1", 512),
+    OD_KERNELS(Surround71, "7.1", 1024), OD_KERNELS(Surround71, "7.1", 2048),
+};
+
+} // namespace
+
+extern "C" const DSPKernels_t* od_dsp_find_kernels(uint32_t channels, uint32_t fft_size) {
+    for (const DSPKernels_t& k : kernel_table) {
+        if (k.channels == channels && k.fft_size == fft_size) return &k;
+    }
+    return nullptr;
+}
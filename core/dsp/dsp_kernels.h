@@ -0,0 +1,39 @@
+#ifndef OD_DSP_KERNELS_H
+#define OD_DSP_KERNELS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "filterbank.h"
+
+/* Specialised per-frame kernels for one standard (channel layout, FFT size) pair.
+ * Instantiated from templates in dsp_kernels.cpp; the engine falls back
+ * to its generic loops when no specialisation exists. */
+
+typedef struct {
+    const char* name;
+    uint32_t channels;
+    uint32_t fft_size;
+
+    /* Interleaved frames → left/right classifier downmix. */
+    void (*downmix)(const float* in, uint32_t n, float* left, float* right);
+
+    /* Interleaved frames → per-channel complex spectra and band energies.
+     * `planes` must hold channels * fft_size floats, `spec_re` / `spec_im`
+     * channels * (fft_size/2 + 1).  Non-directional channels are left untouched. */
+    void (*channel_bands)(const float* in, uint32_t n, const Filterbank_t* fb, float* planes,
+                          float* spec_re, float* spec_im, float band_energy[][OD_MAX_BANDS]);
+
+    /* Energy-weighted unit-vector sum per band; NULL for stereo, which pans. */
+    void (*steer)(const float band_energy[][OD_MAX_BANDS], uint32_t num_bands,
+                  float* vx, float* vy, float* total);
+} DSPKernels_t;
+
+const DSPKernels_t* od_dsp_find_kernels(uint32_t channels, uint32_t fft_size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
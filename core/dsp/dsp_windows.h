@@ -6,6 +6,8 @@ extern "C" {
 #endif
 
 #include "../driver/capture_windows.h"
+#include "../events/events.h"
+#include "dsp_config.h"
 
 typedef struct {
     float azimuth_angle;
@@ -13,6 +15,7 @@ typedef struct {
     int signature_match_id;
     float confidence;
     int sound_type;      
+    float elevation_angle;  /* degrees above ear level, 0 without height channels */
 } SoundEntity_t;
 
 typedef struct {
@@ -20,9 +23,24 @@ typedef struct {
     int entity_count;
 } SpatialData_t;
 
-
+typedef struct DSPContext DSPContext_t;
+typedef void (*SoundEventSink_t)(const SoundEvent_t* event, void* user);
+
+
+__declspec(dllexport) void OD_DSP_DefaultConfig(DSPConfig_t* config);
+__declspec(dllexport) int OD_DSP_ParseBandLayout(const char* spec, BandLayout_t* layout);
+__declspec(dllexport) int OD_DSP_ParseChannelMap(const char* spec, ChannelMap_t* map);
+__declspec(dllexport) DSPContext_t* OD_DSP_CreateContext(const DSPConfig_t* config);
+__declspec(dllexport) void OD_DSP_DestroyContext(DSPContext_t* ctx);
+__declspec(dllexport) int OD_DSP_SetBandLayout(DSPContext_t* ctx, const BandLayout_t* layout);
+__declspec(dllexport) int OD_DSP_SetLabelSmoothing(DSPContext_t* ctx, const LabelSmoothing_t* labels);
+__declspec(dllexport) SpatialData_t OD_DSP_Process(DSPContext_t* ctx, const AudioBuffer_t* buffer, float sensitivity, float separation);
+__declspec(dllexport) void OD_DSP_ResetStream(DSPContext_t* ctx);
+__declspec(dllexport) void OD_DSP_SetEventSink(DSPContext_t* ctx, SoundEventSink_t sink, void* user);
+__declspec(dllexport) DSPContext_t* OD_DSP_GetDefaultContext(void);
 __declspec(dllexport) SpatialData_t OD_DSP_ProcessBuffer(const AudioBuffer_t* buffer, float sensitivity, float separation);
 __declspec(dllexport) int OD_DSP_LoadSignature(int id, const char* file_path);
+__declspec(dllexport) void OD_DSP_ClearSignatures(void);
 
 
 #ifdef __cplusplus
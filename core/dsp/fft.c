@@ -0,0 +1,129 @@
+#include "fft.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define PI 3.14159265358979323846
+
+int od_fft_init(FFTPlan_t* plan, uint32_t size) {
+    memset(plan, 0, sizeof(FFTPlan_t));
+    if (size < 4 || (size & (size - 1)) != 0) return 0;
+
+    uint32_t half = size / 2;
+    plan->size = size;
+    plan->half = half;
+    plan->bitrev   = (uint32_t*)malloc(half * sizeof(uint32_t));
+    plan->tw_re    = (float*)malloc((half / 2) * sizeof(float));
+    plan->tw_im    = (float*)malloc((half / 2) * sizeof(float));
+    plan->split_re = (float*)malloc((half + 1) * sizeof(float));
+    plan->split_im = (float*)malloc((half + 1) * sizeof(float));
+    plan->re       = (float*)malloc(half * sizeof(float));
+    plan->im       = (float*)malloc(half * sizeof(float));
+    if (!plan->bitrev || !plan->tw_re || !plan->tw_im || !plan->split_re ||
+        !plan->split_im || !plan->re || !plan->im) {
+        od_fft_free(plan);
+        return 0;
+    }
+
+    uint32_t bits = 0;
+    while ((1u << bits) < half) bits++;
+    for (uint32_t i = 0; i < half; i++) {
+        uint32_t r = 0;
+        for (uint32_t b = 0; b < bits; b++) {
+            if (i & (1u << b)) r |= 1u << (bits - 1 - b);
+        }
+        plan->bitrev[i] = r;
+    }
+
+    for (uint32_t j = 0; j < half / 2; j++) {
+        double a = -2.0 * PI * (double)j / (double)half;
+        plan->tw_re[j] = (float)cos(a);
+        plan->tw_im[j] = (float)sin(a);
+    }
+
+    for (uint32_t k = 0; k <= half; k++) {
+        double a = -2.0 * PI * (double)k / (double)size;
+        plan->split_re[k] = (float)cos(a);
+        plan->split_im[k] = (float)sin(a);
+    }
+    return 1;
+}
+
+void od_fft_free(FFTPlan_t* plan) {
+    free(plan->bitrev);
+    free(plan->tw_re);
+    free(plan->tw_im);
+    free(plan->split_re);
+    free(plan->split_im);
+    free(plan->re);
+    free(plan->im);
+    memset(plan, 0, sizeof(FFTPlan_t));
+}
+
+/* Packed half-length transform of `in` into plan->re/im. */
+static void transform(const FFTPlan_t* plan, const float* in, uint32_t n) {
+    uint32_t half = plan->half;
+    float* re = plan->re;
+    float* im = plan->im;
+
+    /* Pack even/odd samples as one complex sequence, bit-reversed. */
+    for (uint32_t k = 0; k < half; k++) {
+        uint32_t i0 = 2 * k, i1 = 2 * k + 1;
+        uint32_t dst = plan->bitrev[k];
+        re[dst] = (i0 < n) ? in[i0] : 0.0f;
+        im[dst] = (i1 < n) ? in[i1] : 0.0f;
+    }
+
+    /* Iterative radix-2 butterflies */
+    for (uint32_t len = 2; len <= half; len <<= 1) {
+        uint32_t hl = len >> 1;
+        uint32_t step = half / len;
+        for (uint32_t base = 0; base < half; base += len) {
+            for (uint32_t j = 0; j < hl; j++) {
+                float wr = plan->tw_re[j * step];
+                float wi = plan->tw_im[j * step];
+                uint32_t a = base + j, b = a + hl;
+                float tr = re[b] * wr - im[b] * wi;
+                float ti = re[b] * wi + im[b] * wr;
+                re[b] = re[a] - tr;
+                im[b] = im[a] - ti;
+                re[a] += tr;
+                im[a] += ti;
+            }
+        }
+    }
+}
+
+/* Splits bin k of the packed transform into the real-input spectrum. */
+static inline void split(const FFTPlan_t* plan, uint32_t k, float* xr, float* xi) {
+    uint32_t half = plan->half;
+    uint32_t ka = (k == half) ? 0 : k;
+    uint32_t kb = (k == 0) ? 0 : half - k;
+    float zr = plan->re[ka], zi = plan->im[ka];
+    float cr = plan->re[kb], ci = -plan->im[kb];
+
+    float er = 0.5f * (zr + cr), ei = 0.5f * (zi + ci);
+    float or_ = 0.5f * (zi - ci), oi = -0.5f * (zr - cr);
+
+    float wr = plan->split_re[k], wi = plan->split_im[k];
+    *xr = er + wr * or_ - wi * oi;
+    *xi = ei + wr * oi + wi * or_;
+}
+
+void od_fft_power(const FFTPlan_t* plan, const float* in, uint32_t n, float* power) {
+    if (n > plan->size) n = plan->size;
+    transform(plan, in, n);
+
+    float norm = 1.0f / (float)(n > 0 ? n : 1);
+    for (uint32_t k = 0; k <= plan->half; k++) {
+        float xr, xi;
+        split(plan, k, &xr, &xi);
+        power[k] = (xr * xr + xi * xi) * norm;
+    }
+}
+
+void od_fft_spectrum(const FFTPlan_t* plan, const float* in, uint32_t n, float* re, float* im) {
+    if (n > plan->size) n = plan->size;
+    transform(plan, in, n);
+    for (uint32_t k = 0; k <= plan->half; k++) split(plan, k, &re[k], &im[k]);
+}
@@ -0,0 +1,42 @@
+#ifndef OD_FFT_H
+#define OD_FFT_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+/* Real-input radix-2 FFT.  A length-N real frame is packed into an
+ * N/2-point complex transform and split afterwards, so one plan costs
+ * roughly half of a full complex FFT.  Plans own their scratch and are
+ * therefore not shared between threads. */
+
+typedef struct {
+    uint32_t size;          /* real length N */
+    uint32_t half;          /* complex length N/2 */
+    uint32_t* bitrev;       /* [half] */
+    float* tw_re;           /* [half/2] e^{-2πij/half} */
+    float* tw_im;
+    float* split_re;        /* [half+1] e^{-2πik/N} */
+    float* split_im;
+    float* re;              /* [half] scratch */
+    float* im;
+} FFTPlan_t;
+
+int  od_fft_init(FFTPlan_t* plan, uint32_t size);
+void od_fft_free(FFTPlan_t* plan);
+
+/* Power spectrum |X[k]|^2 / n for k = 0..size/2 of the first n samples
+ * of `in`, zero-padded to the plan size. */
+void od_fft_power(const FFTPlan_t* plan, const float* in, uint32_t n, float* power);
+
+/* The same transform kept complex and unnormalised: X[k] for k = 0..size/2.
+ * Spectra of different channels can be mixed linearly afterwards. */
+void od_fft_spectrum(const FFTPlan_t* plan, const float* in, uint32_t n, float* re, float* im);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,201 @@
+#include "filterbank.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* ──────────────────── Frequency scales ──────────────────── */
+
+/* Traunmüller (1990) Bark approximation */
+static float hz_to_bark(float hz) { return 26.81f * hz / (1960.0f + hz) - 0.53f; }
+static float bark_to_hz(float z)  { return 1960.0f * (z + 0.53f) / (26.28f - z); }
+
+/* Glasberg & Moore (1990) ERB-rate */
+static float hz_to_erb(float hz) { return 21.4f * log10f(1.0f + 0.00437f * hz); }
+static float erb_to_hz(float e)  { return (powf(10.0f, e / 21.4f) - 1.0f) / 0.00437f; }
+
+/* HTK mel scale */
+static float hz_to_mel(float hz) { return 2595.0f * log10f(1.0f + hz / 700.0f); }
+static float mel_to_hz(float m)  { return 700.0f * (powf(10.0f, m / 2595.0f) - 1.0f); }
+
+/* Original fixed bands, expressed as bin edges of a 512-point FFT at 48 kHz. */
+static const float legacy_edge_bins[] = { 0.5f, 5.5f, 20.5f, 84.5f, 255.5f };
+#define LEGACY_BANDS 4
+
+static int compute_edges(const BandLayout_t* layout, float nyquist, float* edges, uint32_t* num_bands) {
+    if (layout->scale == BAND_SCALE_LEGACY) {
+        for (int i = 0; i <= LEGACY_BANDS; i++) {
+            edges[i] = legacy_edge_bins[i] * (48000.0f / 512.0f);
+            if (edges[i] > nyquist) edges[i] = nyquist;
+        }
+        *num_bands = LEGACY_BANDS;
+        return 1;
+    }
+
+    uint32_t nb = layout->num_bands;
+    if (nb < 1 || nb > OD_MAX_BANDS) return 0;
+
+    float lo = layout->min_hz > 0.0f ? layout->min_hz : 50.0f;
+    float hi = layout->max_hz > 0.0f ? layout->max_hz : 16000.0f;
+    if (hi > nyquist) hi = nyquist;
+    if (lo >= hi) return 0;
+
+    for (uint32_t i = 0; i <= nb; i++) {
+        float t = (float)i / (float)nb;
+        switch (layout->scale) {
+            case BAND_SCALE_LOG:
+                edges[i] = lo * powf(hi / lo, t);
+                break;
+            case BAND_SCALE_BARK: {
+                float z0 = hz_to_bark(lo), z1 = hz_to_bark(hi);
+                edges[i] = bark_to_hz(z0 + (z1 - z0) * t);
+                break;
+            }
+            case BAND_SCALE_ERB: {
+                float e0 = hz_to_erb(lo), e1 = hz_to_erb(hi);
+                edges[i] = erb_to_hz(e0 + (e1 - e0) * t);
+                break;
+            }
+            default:
+                return 0;
+        }
+    }
+    edges[0] = lo;
+    edges[nb] = hi;
+    *num_bands = nb;
+    return 1;
+}
+
+/* ──────────────────── Table construction ──────────────────── */
+
+int od_filterbank_build(Filterbank_t* fb, const BandLayout_t* layout, uint32_t fft_size, uint32_t sample_rate) {
+    memset(fb, 0, sizeof(Filterbank_t));
+    if (!layout || fft_size < 4 || sample_rate == 0) return 0;
+
+    float nyquist = 0.5f * (float)sample_rate;
+    float df = (float)sample_rate / (float)fft_size;
+    uint32_t num_bins = fft_size / 2 + 1;
+
+    if (!compute_edges(layout, nyquist, fb->edge_hz, &fb->num_bands)) return 0;
+
+    uint32_t capacity = num_bins + 2 * fb->num_bands;
+    fb->bin = (uint16_t*)malloc(capacity * sizeof(uint16_t));
+    fb->weight = (float*)malloc(capacity * sizeof(float));
+    if (!fb->bin || !fb->weight) {
+        od_filterbank_free(fb);
+        return 0;
+    }
+    fb->num_bins = num_bins;
+
+    uint32_t nnz = 0;
+    for (uint32_t b = 0; b < fb->num_bands; b++) {
+        float lo = fb->edge_hz[b], hi = fb->edge_hz[b + 1];
+        fb->row_start[b] = nnz;
+
+        /* Bin k covers [(k - 0.5) df, (k + 0.5) df]; DC is never used. */
+        int32_t k0 = (int32_t)floorf(lo / df + 0.5f);
+        int32_t k1 = (int32_t)ceilf(hi / df - 0.5f);
+        if (k0 < 1) k0 = 1;
+        if (k1 > (int32_t)num_bins - 1) k1 = (int32_t)num_bins - 1;
+
+        float total = 0.0f;
+        uint32_t row = nnz;
+        for (int32_t k = k0; k <= k1 && nnz < capacity; k++) {
+            float bl = ((float)k - 0.5f) * df, bh = ((float)k + 0.5f) * df;
+            float ol = bl > lo ? bl : lo;
+            float oh = bh < hi ? bh : hi;
+            float w = (oh - ol) / df;
+            if (w <= 1e-4f) continue;
+            fb->bin[nnz] = (uint16_t)k;
+            fb->weight[nnz] = w;
+            total += w;
+            nnz++;
+        }
+        if (total > 0.0f) {
+            for (uint32_t e = row; e < nnz; e++) fb->weight[e] /= total;
+        }
+    }
+    fb->row_start[fb->num_bands] = nnz;
+    return 1;
+}
+
+int od_filterbank_build_mel(Filterbank_t* fb, uint32_t num_bands, float min_hz, float max_hz,
+                            uint32_t fft_size, uint32_t sample_rate) {
+    memset(fb, 0, sizeof(Filterbank_t));
+    if (num_bands < 1 || num_bands > OD_MAX_BANDS || fft_size < 4 || sample_rate == 0) return 0;
+
+    float nyquist = 0.5f * (float)sample_rate;
+    float df = (float)sample_rate / (float)fft_size;
+    uint32_t num_bins = fft_size / 2 + 1;
+    if (max_hz > nyquist) max_hz = nyquist;
+    if (min_hz < 0.0f || min_hz >= max_hz) return 0;
+
+    /* num_bands + 2 points: each band's foot, peak and far foot. */
+    float point[OD_MAX_BANDS + 2];
+    float m0 = hz_to_mel(min_hz), m1 = hz_to_mel(max_hz);
+    for (uint32_t i = 0; i < num_bands + 2; i++) {
+        point[i] = mel_to_hz(m0 + (m1 - m0) * (float)i / (float)(num_bands + 1));
+    }
+
+    /* A bin falls under at most two triangles. */
+    uint32_t capacity = 2 * num_bins + num_bands;
+    fb->bin = (uint16_t*)malloc(capacity * sizeof(uint16_t));
+    fb->weight = (float*)malloc(capacity * sizeof(float));
+    if (!fb->bin || !fb->weight) {
+        od_filterbank_free(fb);
+        return 0;
+    }
+    fb->num_bins = num_bins;
+    fb->num_bands = num_bands;
+
+    uint32_t nnz = 0;
+    for (uint32_t b = 0; b < num_bands; b++) {
+        float lo = point[b], mid = point[b + 1], hi = point[b + 2];
+        fb->edge_hz[b] = lo;
+        fb->row_start[b] = nnz;
+
+        int32_t k0 = (int32_t)ceilf(lo / df);
+        int32_t k1 = (int32_t)floorf(hi / df);
+        if (k0 < 1) k0 = 1;
+        if (k1 > (int32_t)num_bins - 1) k1 = (int32_t)num_bins - 1;
+
+        float total = 0.0f;
+        uint32_t row = nnz;
+        for (int32_t k = k0; k <= k1; k++) {
+            float f = (float)k * df;
+            float w = f < mid ? (f - lo) / (mid - lo) : (hi - f) / (hi - mid);
+            if (w <= 1e-4f) continue;
+            fb->bin[nnz] = (uint16_t)k;
+            fb->weight[nnz] = w;
+            total += w;
+            nnz++;
+        }
+        if (total > 0.0f) {
+            for (uint32_t e = row; e < nnz; e++) fb->weight[e] /= total;
+        } else {
+            /* Narrower than a bin at low frequencies: take the nearest one. */
+            int32_t k = (int32_t)floorf(mid / df + 0.5f);
+            fb->bin[nnz] = (uint16_t)(k < 1 ? 1 : (k > (int32_t)num_bins - 1 ? (int32_t)num_bins - 1 : k));
+            fb->weight[nnz] = 1.0f;
+            nnz++;
+        }
+    }
+    fb->edge_hz[num_bands] = point[num_bands];
+    fb->row_start[num_bands] = nnz;
+    return 1;
+}
+
+void od_filterbank_free(Filterbank_t* fb) {
+    free(fb->bin);
+    free(fb->weight);
+    memset(fb, 0, sizeof(Filterbank_t));
+}
+
+void od_filterbank_apply(const Filterbank_t* fb, const float* power, float* band_energy) {
+    for (uint32_t b = 0; b < fb->num_bands; b++) {
+        float acc = 0.0f;
+        for (uint32_t e = fb->row_start[b]; e < fb->row_start[b + 1]; e++) {
+            acc += fb->weight[e] * power[fb->bin[e]];
+        }
+        band_energy[b] = acc;
+    }
+}
@@ -0,0 +1,41 @@
+#ifndef OD_FILTERBANK_H
+#define OD_FILTERBANK_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "dsp_config.h"
+
+/* Sparse band-weight matrix in CSR form: band b owns the entries
+ * [row_start[b], row_start[b+1]) of bin[] / weight[].  Weights are the
+ * fractional overlap of each FFT bin with the band, normalised so every
+ * band reports the mean power per bin regardless of its width. */
+
+typedef struct {
+    uint32_t num_bands;
+    uint32_t num_bins;                      /* fft_size/2 + 1 */
+    uint32_t row_start[OD_MAX_BANDS + 1];
+    uint16_t* bin;
+    float* weight;
+    float edge_hz[OD_MAX_BANDS + 1];
+} Filterbank_t;
+
+int  od_filterbank_build(Filterbank_t* fb, const BandLayout_t* layout, uint32_t fft_size, uint32_t sample_rate);
+
+/* Overlapping triangular filters evenly spaced on the mel scale between
+ * min_hz and max_hz, as used for MFCCs.  Each triangle spans the centres
+ * of its neighbours and is normalised like the rectangular bands;
+ * edge_hz[b] is the lower foot of band b. */
+int  od_filterbank_build_mel(Filterbank_t* fb, uint32_t num_bands, float min_hz, float max_hz,
+                             uint32_t fft_size, uint32_t sample_rate);
+void od_filterbank_free(Filterbank_t* fb);
+
+/* band_energy[b] = Σ weight * power[bin] — one sparse matrix-vector product. */
+void od_filterbank_apply(const Filterbank_t* fb, const float* power, float* band_energy);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
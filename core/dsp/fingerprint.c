@@ -0,0 +1,142 @@
+#include "fingerprint.h"
+#include <math.h>
+#include <string.h>
+
+void od_fp_reset(FingerprintState_t* s) {
+    memset(s, 0, sizeof(*s));
+}
+
+/* ──────────────────── Peaks and pairs ──────────────────── */
+
+uint32_t od_fp_peaks(const float* power, uint32_t bins, float bin_hz, FingerprintPeak_t* peaks) {
+    float strongest = 0.0f;
+    for (uint32_t k = 2; k + 2 < bins; k++) {
+        if (power[k] > strongest) strongest = power[k];
+    }
+    if (strongest <= 0.0f) return 0;
+    float floor = strongest * OD_FP_RANGE;
+
+    uint32_t count = 0;
+    for (uint32_t k = 2; k + 2 < bins; k++) {
+        float p = power[k];
+        if (p < floor || p <= power[k - 1] || p < power[k + 1] || p <= power[k - 2] || p < power[k + 2]) continue;
+        if (count == OD_FP_PEAKS && p <= peaks[count - 1].power) continue;
+
+        /* Parabolic fit over the log power places the peak between bins. */
+        float a = logf(power[k - 1] + 1e-20f), b = logf(p), c = logf(power[k + 1] + 1e-20f);
+        float den = a - 2.0f * b + c;
+        float delta = den < 0.0f ? 0.5f * (a - c) / den : 0.0f;
+        float grid = ((float)k + delta) * bin_hz / OD_FP_HZ + 0.5f;
+        uint32_t f = grid > 255.0f ? 255u : (uint32_t)grid;
+
+        uint32_t i = count < OD_FP_PEAKS ? count++ : OD_FP_PEAKS - 1;
+        for (; i > 0 && peaks[i - 1].power < p; i--) peaks[i] = peaks[i - 1];
+        peaks[i].bin = (uint16_t)k;
+        peaks[i].f = (uint16_t)f;
+        peaks[i].power = p;
+    }
+    return count;
+}
+
+uint32_t od_fp_push(FingerprintState_t* s, const FingerprintPeak_t* peaks, uint32_t count, uint32_t tick,
+                    FingerprintPair_t* pairs) {
+    uint32_t n = 0;
+    uint32_t history = s->frames < OD_FP_FAN ? s->frames : OD_FP_FAN;
+    for (uint32_t h = 0; h < history; h++) {
+        uint32_t slot = (s->head + OD_FP_FAN - 1 - h) % OD_FP_FAN;
+        uint32_t dt = tick - s->tick[slot];
+        if (dt == 0 || dt > 15) continue;
+        for (uint32_t a = 0; a < s->count[slot]; a++) {
+            const FingerprintPeak_t* anchor = &s->peaks[slot][a];
+            for (uint32_t t = 0; t < count; t++) {
+                int df = (int)peaks[t].f - (int)anchor->f;
+                if (df < -OD_FP_MAX_DF || df > OD_FP_MAX_DF) continue;
+                pairs[n].hash = ((uint32_t)anchor->f << 12) | ((uint32_t)(df + 128) << 4) | dt;
+                pairs[n].anchor_tick = s->tick[slot];
+                pairs[n].target = t;
+                n++;
+            }
+        }
+    }
+
+    memcpy(s->peaks[s->head], peaks, count * sizeof(FingerprintPeak_t));
+    s->count[s->head] = count;
+    s->tick[s->head] = tick;
+    s->head = (s->head + 1) % OD_FP_FAN;
+    s->frames++;
+    return n;
+}
+
+/* ──────────────────── Voting ──────────────────── */
+
+int od_fp_compare(const void* a, const void* b) {
+    const Landmark_t* x = (const Landmark_t*)a;
+    const Landmark_t* y = (const Landmark_t*)b;
+    if (x->hash != y->hash) return x->hash < y->hash ? -1 : 1;
+    if (x->id != y->id) return x->id < y->id ? -1 : 1;
+    if (x->tick != y->tick) return x->tick < y->tick ? -1 : 1;
+    return 0;
+}
+
+void od_fp_index(const Landmark_t* table, uint32_t count, uint32_t* index) {
+    uint32_t i = 0;
+    for (uint32_t b = 0; b < OD_FP_INDEX_SIZE; b++) {
+        index[b] = i;
+        while (i < count && (table[i].hash >> OD_FP_INDEX_SHIFT) == b) i++;
+    }
+    index[OD_FP_INDEX_SIZE] = count;
+}
+
+/* Vote cells are direct-mapped on (id, offset).  Chance collisions are
+ * mostly single votes, so a cell holding one vote (or none recently) goes
+ * to the newcomer, while a cell that has gathered votes keeps them. */
+static FingerprintCell_t* cell(FingerprintState_t* s, int32_t id, int32_t offset) {
+    uint32_t h = (uint32_t)id * 0x9E3779B1u ^ (uint32_t)offset * 0x85EBCA77u;
+    h ^= h >> 15;
+    return &s->cells[h & (OD_FP_CELLS - 1)];
+}
+
+static uint32_t live_votes(FingerprintState_t* s, int32_t id, int32_t offset, uint32_t tick) {
+    const FingerprintCell_t* c = cell(s, id, offset);
+    return (c->id == id && c->offset == offset && tick - c->last <= OD_FP_WINDOW) ? c->votes : 0;
+}
+
+void od_fp_vote(FingerprintState_t* s, const Landmark_t* table, const uint32_t* index,
+                const FingerprintPair_t* pairs, uint32_t pair_count, uint32_t tick, FingerprintHit_t* hit) {
+    for (uint32_t t = 0; t < OD_FP_PEAKS; t++) {
+        hit[t].id = -1;
+        hit[t].votes = 0;
+    }
+
+    for (uint32_t p = 0; p < pair_count; p++) {
+        uint32_t hash = pairs[p].hash;
+        uint32_t first = index[hash >> OD_FP_INDEX_SHIFT], last = index[(hash >> OD_FP_INDEX_SHIFT) + 1];
+        while (first < last && table[first].hash < hash) first++;
+        uint32_t end = first;
+        while (end < last && table[end].hash == hash && end - first <= OD_FP_MAX_BUCKET) end++;
+        if (end - first > OD_FP_MAX_BUCKET) continue;
+
+        FingerprintHit_t* h = &hit[pairs[p].target];
+        for (uint32_t i = first; i < end; i++) {
+            int32_t id = table[i].id;
+            int32_t offset = (int32_t)(table[i].tick - pairs[p].anchor_tick);
+            FingerprintCell_t* c = cell(s, id, offset);
+            if (c->id != id || c->offset != offset || tick - c->last > OD_FP_WINDOW) {
+                if (c->votes > 1 && tick - c->last <= OD_FP_WINDOW) continue;
+                c->id = id;
+                c->offset = offset;
+                c->votes = 0;
+            }
+            c->votes++;
+            c->last = tick;
+
+            /* Block boundaries fall anywhere between ticks, so a true match
+             * can straddle two neighbouring offsets. */
+            uint32_t votes = c->votes + live_votes(s, id, offset - 1, tick) + live_votes(s, id, offset + 1, tick);
+            if (votes >= OD_FP_MIN_VOTES && votes > h->votes) {
+                h->id = id;
+                h->votes = votes;
+            }
+        }
+    }
+}
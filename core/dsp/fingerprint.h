@@ -0,0 +1,112 @@
+#ifndef OD_FINGERPRINT_H
+#define OD_FINGERPRINT_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+/* Landmark fingerprints of replayed game samples.
+ *
+ * Each frame keeps its OD_FP_PEAKS strongest spectral peaks, with the
+ * frequency snapped to an OD_FP_HZ grid.  Every peak (the target) is
+ * paired with the peaks of the previous OD_FP_FAN frames (the anchors)
+ * within OD_FP_MAX_DF grid steps, and each pair hashes to
+ *
+ *   anchor frequency (8 bits) | target - anchor (8 bits) | ticks apart (4 bits)
+ *
+ * Times are OD_FP_TICK_US ticks of stream time, so hashes do not depend on
+ * the capture block size.  A reference clip stores (hash, id, anchor tick)
+ * for every pair, sorted by hash.  Live, every pair found in that table
+ * votes for (id, reference tick - live tick): a replay of the clip piles
+ * its votes on one offset, while chance collisions scatter.  A signature
+ * is reported once its offset, give or take a tick, holds OD_FP_MIN_VOTES
+ * votes; an offset is forgotten after OD_FP_WINDOW ticks without one. */
+
+#define OD_FP_TICK_US       10000u
+#define OD_FP_HZ            100.0f
+#define OD_FP_PEAKS         4           /* strongest peaks kept per frame */
+#define OD_FP_FAN           4           /* frames an anchor may lead its target by */
+#define OD_FP_MAX_DF        32          /* grid steps between anchor and target */
+#define OD_FP_RANGE         1e-3f       /* peaks within 30 dB of the frame's strongest */
+#define OD_FP_MAX_BUCKET    64          /* hashes this common are ignored */
+#define OD_FP_WINDOW        50          /* ticks a vote counts for */
+#define OD_FP_MIN_VOTES     6
+#define OD_FP_CELLS         8192        /* vote cells per stream, a power of two; about a window of chance votes */
+#define OD_FP_MAX_PAIRS     (OD_FP_PEAKS * OD_FP_FAN * OD_FP_PEAKS)
+#define OD_FP_INDEX_SHIFT   4           /* the index skips the tick bits of a hash */
+#define OD_FP_INDEX_SIZE    (1u << (20 - OD_FP_INDEX_SHIFT))
+
+typedef struct {
+    uint16_t bin;
+    uint16_t f;                 /* OD_FP_HZ grid step */
+    float power;
+} FingerprintPeak_t;
+
+typedef struct {
+    uint32_t hash;
+    uint32_t anchor_tick;
+    uint32_t target;            /* index of the target peak in its frame */
+} FingerprintPair_t;
+
+typedef struct {
+    uint32_t hash;
+    int32_t id;
+    uint32_t tick;              /* anchor tick within the clip */
+} Landmark_t;
+
+/* Votes for one signature at one alignment. */
+typedef struct {
+    int32_t id;
+    int32_t offset;
+    uint32_t votes;
+    uint32_t last;              /* tick of the latest vote */
+} FingerprintCell_t;
+
+/* Stream state: the peaks of the last OD_FP_FAN frames and the votes. */
+typedef struct {
+    FingerprintPeak_t peaks[OD_FP_FAN][OD_FP_PEAKS];
+    uint32_t count[OD_FP_FAN];
+    uint32_t tick[OD_FP_FAN];
+    uint32_t head;
+    uint32_t frames;
+    FingerprintCell_t cells[OD_FP_CELLS];
+} FingerprintState_t;
+
+/* Best confirmed signature a peak voted for this frame. */
+typedef struct {
+    int32_t id;                 /* -1 = none */
+    uint32_t votes;
+} FingerprintHit_t;
+
+void od_fp_reset(FingerprintState_t* s);
+
+/* Strongest peaks of a power spectrum of `bins` bins, `bin_hz` apart,
+ * loudest first.  Returns the count (<= OD_FP_PEAKS). */
+uint32_t od_fp_peaks(const float* power, uint32_t bins, float bin_hz, FingerprintPeak_t* peaks);
+
+/* Pairs a frame's peaks with those of the frames before it, then makes it
+ * the newest frame of the history.  Returns the pair count. */
+uint32_t od_fp_push(FingerprintState_t* s, const FingerprintPeak_t* peaks, uint32_t count, uint32_t tick,
+                    FingerprintPair_t* pairs);
+
+/* index[b] is where the hashes with top bits b start in `table` (sorted by
+ * hash); OD_FP_INDEX_SIZE + 1 entries, the last one the table size.  A
+ * lookup then reads one entry and a short run instead of binary searching
+ * a table that does not fit in cache. */
+void od_fp_index(const Landmark_t* table, uint32_t count, uint32_t* index);
+
+/* Votes the pairs of the frame at `tick` against `table` and fills
+ * hit[target] for each of the frame's peaks. */
+void od_fp_vote(FingerprintState_t* s, const Landmark_t* table, const uint32_t* index,
+                const FingerprintPair_t* pairs, uint32_t pair_count, uint32_t tick, FingerprintHit_t* hit);
+
+/* qsort order for Landmark_t. */
+int od_fp_compare(const void* a, const void* b);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
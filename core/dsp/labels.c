@@ -0,0 +1,88 @@
+#include "labels.h"
+#include <math.h>
+#include <string.h>
+
+#define RING        OD_MAX_LABEL_LAG
+#define SCORE_FLOOR 0.01f           /* scores below this all look equally unlikely */
+#define UNREACHED   -1e30f
+
+/* LabelSmoothing_t is indexed by SoundType_t. */
+typedef char od_labels_types_fit[SOUND_TYPE_COUNT <= OD_MAX_SOUND_TYPES ? 1 : -1];
+
+void od_labels_default(LabelSmoothing_t* p) {
+    memset(p, 0, sizeof(*p));
+    p->enabled = 1;
+    p->lag = 0;
+    for (int i = 0; i < SOUND_TYPE_COUNT; i++) {
+        for (int j = 0; j < SOUND_TYPE_COUNT; j++) {
+            /* Starting a sound is cheap so onsets are labelled at once;
+             * dropping one to Unknown or swapping it for another must be
+             * earned. */
+            if (i == SOUND_UNKNOWN) p->penalty[i][j] = 0.25f;
+            else if (j == SOUND_UNKNOWN) p->penalty[i][j] = 1.0f;
+            else p->penalty[i][j] = 2.0f;
+        }
+    }
+    p->min_frames[SOUND_UNKNOWN] = 1;
+    p->min_frames[SOUND_FOOTSTEP] = 2;
+    p->min_frames[SOUND_AR] = 2;
+    p->min_frames[SOUND_SMG] = 2;
+    p->min_frames[SOUND_SR] = 2;
+    p->min_frames[SOUND_DMR] = 2;
+    p->min_frames[SOUND_GRENADE] = 3;
+    p->min_frames[SOUND_SMOKE] = 4;
+    p->min_frames[SOUND_VEHICLE] = 8;
+}
+
+void od_labels_reset(LabelTrack_t* t) {
+    memset(t, 0, sizeof(*t));
+}
+
+SoundType_t od_labels_step(LabelTrack_t* t, const LabelSmoothing_t* p, const float* scores) {
+    if (t->frames == 0) {
+        for (int j = 0; j < SOUND_TYPE_COUNT; j++) {
+            t->score[j] = UNREACHED;
+            t->run[j] = 0;
+        }
+        t->score[SOUND_UNKNOWN] = 0.0f;
+        t->run[SOUND_UNKNOWN] = UINT16_MAX;
+    }
+
+    uint8_t* from = t->from[t->head];
+    float next[SOUND_TYPE_COUNT];
+    uint16_t run[SOUND_TYPE_COUNT];
+    float top = UNREACHED;
+    int best = SOUND_UNKNOWN;
+    for (int j = 0; j < SOUND_TYPE_COUNT; j++) {
+        float s = t->score[j];
+        int prev = j;
+        for (int i = 0; i < SOUND_TYPE_COUNT; i++) {
+            if (i == j || t->run[i] < p->min_frames[i]) continue;
+            float v = t->score[i] - p->penalty[i][j];
+            if (v > s) {
+                s = v;
+                prev = i;
+            }
+        }
+        float e = scores[j] > 0.0f ? scores[j] : 0.0f;
+        next[j] = s + logf(e + SCORE_FLOOR);
+        from[j] = (uint8_t)prev;
+        run[j] = prev != j ? 1 : t->run[j] < UINT16_MAX ? (uint16_t)(t->run[j] + 1) : UINT16_MAX;
+        if (next[j] > top) {
+            top = next[j];
+            best = j;
+        }
+    }
+
+    /* Only differences matter; keep the best path at zero. */
+    for (int j = 0; j < SOUND_TYPE_COUNT; j++) {
+        t->score[j] = next[j] - top;
+        t->run[j] = run[j];
+    }
+    t->head = (t->head + 1) % RING;
+    if (t->frames < UINT32_MAX) t->frames++;
+
+    uint32_t lag = p->lag < t->frames ? p->lag : t->frames - 1;
+    for (uint32_t k = 0; k < lag; k++) best = t->from[(t->head + RING - 1 - k) % RING][best];
+    return (SoundType_t)best;
+}
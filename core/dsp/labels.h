@@ -0,0 +1,51 @@
+#ifndef OD_LABELS_H
+#define OD_LABELS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "dsp_config.h"
+#ifdef _WIN32
+#include "classifier_windows.h"
+#else
+#include "classifier.h"
+#endif
+
+/* Sound types decoded over time instead of picked per frame.
+ *
+ * Each track (the frame as a whole, or the entity a band feeds) is a hidden
+ * Markov chain over the sound types.  A frame's classifier scores are its
+ * emissions, log(score), and LabelSmoothing_t gives the transition costs:
+ * a penalty per (from, to) pair, and no way out of a type before it has
+ * lasted min_frames.  Viterbi keeps, for every type, the best path ending
+ * there, so a step costs O(types^2).
+ *
+ * With lag L the label reported is where the best path stood L frames ago,
+ * read back through a ring of back-pointers.  Later frames can still
+ * revise those L frames, which is what removes one-frame blips, at the cost
+ * of labels trailing the audio by L frames; with L = 0 the penalties alone
+ * hold a label until the evidence for another outweighs them. */
+
+typedef struct {
+    float score[SOUND_TYPE_COUNT];                      /* log score of the best path into each type, best = 0 */
+    uint16_t run[SOUND_TYPE_COUNT];                     /* frames that path has spent in the type */
+    uint8_t from[OD_MAX_LABEL_LAG][SOUND_TYPE_COUNT];   /* back-pointers, newest at head - 1 */
+    uint32_t head;
+    uint32_t frames;                                    /* since reset; 0 starts in Unknown */
+} LabelTrack_t;
+
+/* Penalties and durations tuned for the built-in sound types, lag 0. */
+void od_labels_default(LabelSmoothing_t* params);
+
+void od_labels_reset(LabelTrack_t* track);
+
+/* Feeds one frame's scores[SOUND_TYPE_COUNT] (OD_Classifier_ScoreFrame)
+ * and returns the type decided for the frame `lag` frames back. */
+SoundType_t od_labels_step(LabelTrack_t* track, const LabelSmoothing_t* params, const float* scores);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
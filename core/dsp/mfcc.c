@@ -0,0 +1,209 @@
+#include "mfcc.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define OD_MFCC_SSE2 1
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define OD_MFCC_NEON 1
+#endif
+
+#define PI 3.14159265358979323846
+#define LOG_FLOOR 1e-10f
+
+/* ──────────────────── Tables ──────────────────── */
+
+int od_mfcc_build(MfccState_t* m, uint32_t fft_size, uint32_t sample_rate) {
+    Filterbank_t mel;
+    if (!od_filterbank_build_mel(&mel, OD_MFCC_BANDS, OD_MFCC_MIN_HZ, OD_MFCC_MAX_HZ, fft_size, sample_rate))
+        return 0;
+    uint32_t bins = fft_size / 2 + 1;
+    float* held = (float*)malloc(OD_MFCC_HELD * (size_t)bins * sizeof(float));
+    if (!held) {
+        od_filterbank_free(&mel);
+        return 0;
+    }
+    od_filterbank_free(&m->mel);
+    free(m->held);
+    m->mel = mel;
+    m->held = held;
+    m->bins = bins;
+
+    /* Orthonormal DCT-II, stored band-major so each band adds one scaled
+     * row to all coefficients at once. */
+    memset(m->dct, 0, sizeof(m->dct));
+    for (uint32_t b = 0; b < OD_MFCC_BANDS; b++) {
+        for (uint32_t j = 0; j < OD_MFCC_COEFFS; j++) {
+            double s = j == 0 ? sqrt(1.0 / OD_MFCC_BANDS) : sqrt(2.0 / OD_MFCC_BANDS);
+            m->dct[b][j] = (float)(s * cos(PI * (double)j * ((double)b + 0.5) / OD_MFCC_BANDS));
+        }
+    }
+    od_mfcc_reset(m);
+    return 1;
+}
+
+void od_mfcc_free(MfccState_t* m) {
+    od_filterbank_free(&m->mel);
+    free(m->held);
+    m->held = NULL;
+}
+
+void od_mfcc_reset(MfccState_t* m) {
+    memset(m->features, 0, sizeof(m->features));
+    m->frames = 0;
+    m->held_count = 0;
+}
+
+/* ──────────────────── Log-mel and DCT ──────────────────── */
+
+#if defined(OD_MFCC_SSE2)
+/* Natural log of four positive normal floats: split off the exponent,
+ * fold the mantissa into [sqrt(1/2), sqrt(2)) and sum the atanh series
+ * ln m = 2 (u + u^3/3 + u^5/5 + u^7/7), u = (m - 1) / (m + 1), |u| < 0.172. */
+static inline __m128 log_ps(__m128 x) {
+    __m128i xi = _mm_castps_si128(x);
+    __m128i e = _mm_sub_epi32(_mm_srli_epi32(xi, 23), _mm_set1_epi32(127));
+    __m128 mant = _mm_castsi128_ps(_mm_or_si128(_mm_and_si128(xi, _mm_set1_epi32(0x007FFFFF)),
+                                                _mm_set1_epi32(0x3F800000)));
+    __m128 big = _mm_cmpgt_ps(mant, _mm_set1_ps(1.41421356f));
+    mant = _mm_or_ps(_mm_and_ps(big, _mm_mul_ps(mant, _mm_set1_ps(0.5f))), _mm_andnot_ps(big, mant));
+    e = _mm_sub_epi32(e, _mm_castps_si128(big));    /* mask is -1 where folded */
+
+    __m128 one = _mm_set1_ps(1.0f);
+    __m128 u = _mm_div_ps(_mm_sub_ps(mant, one), _mm_add_ps(mant, one));
+    __m128 u2 = _mm_mul_ps(u, u);
+    __m128 p = _mm_add_ps(_mm_set1_ps(1.0f / 5.0f), _mm_mul_ps(u2, _mm_set1_ps(1.0f / 7.0f)));
+    p = _mm_add_ps(_mm_set1_ps(1.0f / 3.0f), _mm_mul_ps(u2, p));
+    p = _mm_add_ps(one, _mm_mul_ps(u2, p));
+    __m128 ln_m = _mm_mul_ps(_mm_mul_ps(_mm_set1_ps(2.0f), u), p);
+    return _mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(e), _mm_set1_ps(0.69314718f)), ln_m);
+}
+#elif defined(OD_MFCC_NEON)
+static inline float32x4_t log_ps(float32x4_t x) {
+    int32x4_t xi = vreinterpretq_s32_f32(x);
+    int32x4_t e = vsubq_s32(vshrq_n_s32(xi, 23), vdupq_n_s32(127));
+    float32x4_t mant = vreinterpretq_f32_s32(vorrq_s32(vandq_s32(xi, vdupq_n_s32(0x007FFFFF)),
+                                                       vdupq_n_s32(0x3F800000)));
+    uint32x4_t big = vcgtq_f32(mant, vdupq_n_f32(1.41421356f));
+    mant = vbslq_f32(big, vmulq_n_f32(mant, 0.5f), mant);
+    e = vsubq_s32(e, vreinterpretq_s32_u32(big));
+
+    float32x4_t one = vdupq_n_f32(1.0f);
+    float32x4_t den = vaddq_f32(mant, one);
+    float32x4_t inv = vrecpeq_f32(den);
+    inv = vmulq_f32(inv, vrecpsq_f32(den, inv));
+    inv = vmulq_f32(inv, vrecpsq_f32(den, inv));
+    float32x4_t u = vmulq_f32(vsubq_f32(mant, one), inv);
+    float32x4_t u2 = vmulq_f32(u, u);
+    float32x4_t p = vmlaq_f32(vdupq_n_f32(1.0f / 5.0f), u2, vdupq_n_f32(1.0f / 7.0f));
+    p = vmlaq_f32(vdupq_n_f32(1.0f / 3.0f), u2, p);
+    p = vmlaq_f32(one, u2, p);
+    float32x4_t ln_m = vmulq_f32(vmulq_n_f32(u, 2.0f), p);
+    return vmlaq_f32(ln_m, vcvtq_f32_s32(e), vdupq_n_f32(0.69314718f));
+}
+#endif
+
+static void log_bands(const float* energy, float floor, float* out) {
+    uint32_t b = 0;
+#if defined(OD_MFCC_SSE2)
+    for (; b + 4 <= OD_MFCC_BANDS; b += 4) {
+        __m128 x = _mm_max_ps(_mm_loadu_ps(energy + b), _mm_set1_ps(floor));
+        _mm_storeu_ps(out + b, log_ps(x));
+    }
+#elif defined(OD_MFCC_NEON)
+    for (; b + 4 <= OD_MFCC_BANDS; b += 4) {
+        float32x4_t x = vmaxq_f32(vld1q_f32(energy + b), vdupq_n_f32(floor));
+        vst1q_f32(out + b, log_ps(x));
+    }
+#endif
+    for (; b < OD_MFCC_BANDS; b++) out[b] = logf(energy[b] > floor ? energy[b] : floor);
+}
+
+static void dct(const MfccState_t* m, const float* log_mel, float* coeff) {
+#if defined(OD_MFCC_SSE2)
+    __m128 a0 = _mm_setzero_ps(), a1 = _mm_setzero_ps(), a2 = _mm_setzero_ps(), a3 = _mm_setzero_ps();
+    for (uint32_t b = 0; b < OD_MFCC_BANDS; b++) {
+        __m128 v = _mm_set1_ps(log_mel[b]);
+        const float* row = m->dct[b];
+        a0 = _mm_add_ps(a0, _mm_mul_ps(v, _mm_loadu_ps(row)));
+        a1 = _mm_add_ps(a1, _mm_mul_ps(v, _mm_loadu_ps(row + 4)));
+        a2 = _mm_add_ps(a2, _mm_mul_ps(v, _mm_loadu_ps(row + 8)));
+        a3 = _mm_add_ps(a3, _mm_mul_ps(v, _mm_loadu_ps(row + 12)));
+    }
+    _mm_storeu_ps(coeff, a0);
+    _mm_storeu_ps(coeff + 4, a1);
+    _mm_storeu_ps(coeff + 8, a2);
+    _mm_storeu_ps(coeff + 12, a3);
+#elif defined(OD_MFCC_NEON)
+    float32x4_t a0 = vdupq_n_f32(0.0f), a1 = a0, a2 = a0, a3 = a0;
+    for (uint32_t b = 0; b < OD_MFCC_BANDS; b++) {
+        const float* row = m->dct[b];
+        a0 = vmlaq_n_f32(a0, vld1q_f32(row), log_mel[b]);
+        a1 = vmlaq_n_f32(a1, vld1q_f32(row + 4), log_mel[b]);
+        a2 = vmlaq_n_f32(a2, vld1q_f32(row + 8), log_mel[b]);
+        a3 = vmlaq_n_f32(a3, vld1q_f32(row + 12), log_mel[b]);
+    }
+    vst1q_f32(coeff, a0);
+    vst1q_f32(coeff + 4, a1);
+    vst1q_f32(coeff + 8, a2);
+    vst1q_f32(coeff + 12, a3);
+#else
+    for (uint32_t j = 0; j < OD_MFCC_DCT_WIDTH; j++) coeff[j] = 0.0f;
+    for (uint32_t b = 0; b < OD_MFCC_BANDS; b++) {
+        for (uint32_t j = 0; j < OD_MFCC_DCT_WIDTH; j++) coeff[j] += m->dct[b][j] * log_mel[b];
+    }
+#endif
+}
+
+static void transform(MfccState_t* m, const float* power) {
+    float energy[OD_MFCC_BANDS], log_mel[OD_MFCC_BANDS], coeff[OD_MFCC_DCT_WIDTH];
+    od_filterbank_apply(&m->mel, power, energy);
+    log_bands(energy, LOG_FLOOR, log_mel);
+    dct(m, log_mel, coeff);
+
+    float* c = m->features;
+    float* d = m->features + OD_MFCC_COEFFS;
+    float* dd = m->features + 2 * OD_MFCC_COEFFS;
+    for (uint32_t j = 0; j < OD_MFCC_COEFFS; j++) {
+        float delta = m->frames > 0 ? coeff[j] - c[j] : 0.0f;
+        dd[j] = m->frames > 1 ? delta - d[j] : 0.0f;
+        d[j] = delta;
+        c[j] = coeff[j];
+    }
+    if (m->frames < 2) m->frames++;
+}
+
+const float* od_mfcc_update(MfccState_t* m, const float* power) {
+    od_mfcc_catch_up(m);
+    transform(m, power);
+    return m->features;
+}
+
+void od_mfcc_hold(MfccState_t* m, const float* power) {
+    memcpy(m->held + (size_t)m->held_next * m->bins, power, m->bins * sizeof(float));
+    m->held_next = (m->held_next + 1) % OD_MFCC_HELD;
+    if (m->held_count < OD_MFCC_HELD) m->held_count++;
+}
+
+const float* od_mfcc_catch_up(MfccState_t* m) {
+    for (uint32_t i = m->held_count; i > 0; i--) {
+        uint32_t slot = (m->held_next + OD_MFCC_HELD - i) % OD_MFCC_HELD;
+        transform(m, m->held + (size_t)slot * m->bins);
+    }
+    m->held_count = 0;
+    return m->features;
+}
+
+void od_mfcc_shape(const MfccState_t* m, const float* power, float range, float* coeff) {
+    float energy[OD_MFCC_BANDS], log_mel[OD_MFCC_BANDS];
+    od_filterbank_apply(&m->mel, power, energy);
+    float peak = 0.0f;
+    for (uint32_t b = 0; b < OD_MFCC_BANDS; b++) {
+        if (energy[b] > peak) peak = energy[b];
+    }
+    float floor = peak * range;
+    log_bands(energy, floor > LOG_FLOOR ? floor : LOG_FLOOR, log_mel);
+    dct(m, log_mel, coeff);
+}
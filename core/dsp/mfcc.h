@@ -0,0 +1,70 @@
+#ifndef OD_MFCC_H
+#define OD_MFCC_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "filterbank.h"
+#ifdef _WIN32
+#include "classifier_windows.h"
+#else
+#include "classifier.h"
+#endif
+
+/* Log-mel cepstrum of each frame's power spectrum.
+ *
+ * The mel filters are a triangular Filterbank_t (CSR), applied to the
+ * spectrum the engine already has; the log and the orthonormal DCT-II run
+ * four lanes at a time.  Deltas are causal first differences (frame t
+ * minus frame t-1) so the vector never waits on future frames; they read
+ * zero until there is history.
+ *
+ * A frame nobody reads the vector of can be held instead: only its
+ * spectrum is kept, and the next frame that is read first transforms the
+ * held ones, so its deltas come out as if none had been skipped.  The
+ * delta-deltas reach two frames back, so only the last OD_MFCC_HELD held
+ * frames are kept. */
+
+#define OD_MFCC_MIN_HZ      60.0f
+#define OD_MFCC_MAX_HZ      12000.0f
+#define OD_MFCC_DCT_WIDTH   16              /* OD_MFCC_COEFFS rounded up to whole vectors */
+#define OD_MFCC_HELD        3               /* frames t-2, t-1 and t */
+
+typedef struct {
+    Filterbank_t mel;
+    float dct[OD_MFCC_BANDS][OD_MFCC_DCT_WIDTH];    /* transposed, zero past OD_MFCC_COEFFS */
+    float features[OD_MFCC_FEATURES];               /* [coeffs | deltas | delta-deltas] */
+    uint32_t frames;                                /* since reset, saturating at 2 */
+    float* held;                                    /* [OD_MFCC_HELD * bins] spectra not transformed yet */
+    uint32_t bins;
+    uint32_t held_count;                            /* 0..OD_MFCC_HELD */
+    uint32_t held_next;                             /* slot the next held spectrum goes to */
+} MfccState_t;
+
+/* Builds the mel bank for (fft_size, sample_rate).  On failure the state
+ * is left as it was and 0 is returned, so it can rebuild in place. */
+int  od_mfcc_build(MfccState_t* m, uint32_t fft_size, uint32_t sample_rate);
+void od_mfcc_free(MfccState_t* m);
+void od_mfcc_reset(MfccState_t* m);
+
+/* `power` is |X[k]|^2 / n over fft_size/2 + 1 bins.  Returns m->features. */
+const float* od_mfcc_update(MfccState_t* m, const float* power);
+
+/* Keeps `power` as the next frame without transforming it. */
+void od_mfcc_hold(MfccState_t* m, const float* power);
+
+/* Transforms the held frames; m->features is then the latest one's. */
+const float* od_mfcc_catch_up(MfccState_t* m);
+
+/* Cepstrum of `power` alone, leaving the delta history untouched, into
+ * OD_MFCC_DCT_WIDTH floats.  Bands more than `range` (a power ratio) below
+ * the strongest are clamped to it, so bins left empty by a partial spectrum
+ * do not dominate the shape. */
+void od_mfcc_shape(const MfccState_t* m, const float* power, float range, float* coeff);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,85 @@
+#include "onset.h"
+#include <math.h>
+#include <string.h>
+
+void od_onset_reset(OnsetTracker_t* tracker) {
+    memset(tracker, 0, sizeof(*tracker));
+    tracker->next_id = 1;
+}
+
+static float angle_diff(float a, float b) {
+    float d = a - b;
+    if (d > 180.0f) d -= 360.0f;
+    if (d < -180.0f) d += 360.0f;
+    return fabsf(d);
+}
+
+static void emit(const OnsetTrack_t* track, const SoundEntity_t* entity, uint64_t now_us,
+                 SoundEventSink_t sink, void* user) {
+    SoundEvent_t event;
+    memset(&event, 0, sizeof(event));
+    event.timestamp_us = now_us;
+    event.azimuth_angle = entity->azimuth_angle;
+    event.elevation_angle = entity->elevation_angle;
+    event.distance = entity->distance;
+    event.confidence = entity->confidence;
+    event.sound_type = entity->sound_type;
+    event.track_id = track->id;
+    event.kind = SOUND_EVENT_ONSET;
+    sink(&event, user);
+}
+
+void od_onset_update(OnsetTracker_t* tracker, const SpatialData_t* result, uint64_t now_us,
+                     SoundEventSink_t sink, void* user) {
+    for (int i = 0; i < OD_ONSET_MAX_TRACKS; i++) {
+        OnsetTrack_t* t = &tracker->tracks[i];
+        if (t->id && now_us - t->last_seen_us > OD_ONSET_EXPIRE_US) t->id = 0;
+    }
+
+    for (int e = 0; e < result->entity_count; e++) {
+        const SoundEntity_t* entity = &result->entities[e];
+
+        OnsetTrack_t* best = NULL;
+        float best_diff = OD_ONSET_MATCH_DEGREES;
+        for (int i = 0; i < OD_ONSET_MAX_TRACKS; i++) {
+            OnsetTrack_t* t = &tracker->tracks[i];
+            if (!t->id) continue;
+            float d = angle_diff(t->azimuth, entity->azimuth_angle);
+            if (d < best_diff) {
+                best_diff = d;
+                best = t;
+            }
+        }
+
+        if (best) {
+            int jump = best->distance - entity->distance >= OD_ONSET_JUMP &&
+                       now_us - best->last_onset_us >= OD_ONSET_REFRACTORY_US;
+            best->azimuth = entity->azimuth_angle;
+            best->distance = 0.7f * best->distance + 0.3f * entity->distance;
+            best->last_seen_us = now_us;
+            if (jump) {
+                best->last_onset_us = now_us;
+                if (sink) emit(best, entity, now_us, sink, user);
+            }
+            continue;
+        }
+
+        /* New direction: take a free slot, else the stalest track. */
+        OnsetTrack_t* slot = &tracker->tracks[0];
+        for (int i = 0; i < OD_ONSET_MAX_TRACKS; i++) {
+            OnsetTrack_t* t = &tracker->tracks[i];
+            if (!t->id) {
+                slot = t;
+                break;
+            }
+            if (t->last_seen_us < slot->last_seen_us) slot = t;
+        }
+        slot->id = tracker->next_id++;
+        if (tracker->next_id == 0) tracker->next_id = 1;
+        slot->azimuth = entity->azimuth_angle;
+        slot->distance = entity->distance;
+        slot->last_seen_us = now_us;
+        slot->last_onset_us = now_us;
+        if (sink) emit(slot, entity, now_us, sink, user);
+    }
+}
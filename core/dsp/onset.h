@@ -0,0 +1,51 @@
+#ifndef OD_ONSET_H
+#define OD_ONSET_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifdef _WIN32
+#include "dsp_windows.h"
+#else
+#include "dsp.h"
+#endif
+
+/* Turns the per-block entity snapshot into discrete onset events.
+ *
+ * Each entity is matched to the nearest live direction track; an entity
+ * with no track within OD_ONSET_MATCH_DEGREES starts a new one, and a
+ * track whose level jumps (its distance estimate drops sharply) after
+ * the refractory time fires again.  Tracks that go unseen for
+ * OD_ONSET_EXPIRE_US are dropped. */
+
+#define OD_ONSET_MAX_TRACKS     16
+#define OD_ONSET_MATCH_DEGREES  25.0f
+#define OD_ONSET_EXPIRE_US      300000u
+#define OD_ONSET_REFRACTORY_US  100000u
+#define OD_ONSET_JUMP           0.15f       /* distance drop that counts as a new hit */
+
+typedef struct {
+    uint32_t id;                /* 0 = free slot */
+    float azimuth;
+    float distance;             /* smoothed */
+    uint64_t last_seen_us;
+    uint64_t last_onset_us;
+} OnsetTrack_t;
+
+typedef struct {
+    OnsetTrack_t tracks[OD_ONSET_MAX_TRACKS];
+    uint32_t next_id;
+} OnsetTracker_t;
+
+void od_onset_reset(OnsetTracker_t* tracker);
+
+/* Feeds one block's result.  Calls `sink` for every onset. */
+void od_onset_update(OnsetTracker_t* tracker, const SpatialData_t* result, uint64_t now_us,
+                     SoundEventSink_t sink, void* user);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
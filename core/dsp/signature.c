@@ -0,0 +1,444 @@
+#include "signature.h"
+#include "fft.h"
+#include "fingerprint.h"
+#include "../driver/audio_file.h"
+#include <math.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define OD_SIGNATURE_SSE2 1
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define OD_SIGNATURE_NEON 1
+#endif
+
+#define LEAF_SIZE     8             /* ranges this small are scanned, not split */
+
+typedef struct {
+    float v[OD_SIGNATURE_DIMS];
+    int32_t id;
+} SignaturePoint_t;
+
+typedef struct {
+    uint32_t count;
+    SignaturePoint_t* points;       /* [count] in tree order */
+    uint8_t* axis;                  /* [count] split axis of the node at each index */
+    uint32_t landmark_count;
+    Landmark_t* landmarks;          /* [landmark_count] sorted by hash */
+    uint32_t* landmark_index;       /* [OD_FP_INDEX_SIZE + 1] see od_fp_index */
+} SignatureIndex_t;
+
+/* The library is rebuilt whole on every load and swapped in, so matching
+ * never waits on a load.  Readers bump `matching` around each lookup; the
+ * loader waits for it to drain before freeing the old tree.  Loads
+ * themselves are serialised by `loading`. */
+static _Atomic(SignatureIndex_t*) library;
+static atomic_int matching;
+static atomic_flag loading = ATOMIC_FLAG_INIT;
+
+static void sleep_1ms(void) {
+#ifdef _WIN32
+    Sleep(1);
+#else
+    struct timespec ts = { 0, 1000000L };
+    nanosleep(&ts, NULL);
+#endif
+}
+
+static void index_free(SignatureIndex_t* ix) {
+    if (!ix) return;
+    free(ix->points);
+    free(ix->axis);
+    free(ix->landmarks);
+    free(ix->landmark_index);
+    free(ix);
+}
+
+static void swap_library(SignatureIndex_t* ix) {
+    SignatureIndex_t* old = atomic_exchange(&library, ix);
+    if (!old) return;
+    while (atomic_load(&matching) != 0) sleep_1ms();
+    index_free(old);
+}
+
+/* ──────────────────── Feature vector ──────────────────── */
+
+void od_signature_vector(const MfccState_t* mfcc, const float* power, float* v) {
+    float coeff[OD_MFCC_DCT_WIDTH];
+    od_mfcc_shape(mfcc, power, OD_SIGNATURE_RANGE, coeff);
+    memcpy(v, coeff + 1, OD_SIGNATURE_DIMS * sizeof(float));
+}
+
+/* ──────────────────── KD-tree ──────────────────── */
+
+static inline void swap_points(SignaturePoint_t* a, SignaturePoint_t* b) {
+    SignaturePoint_t t = *a;
+    *a = *b;
+    *b = t;
+}
+
+/* Reorders p[lo, hi) so that p[k] holds the element that sorts there on
+ * `axis`, with nothing greater before it and nothing smaller after. */
+static void select_kth(SignaturePoint_t* p, uint32_t lo, uint32_t hi, uint32_t k, uint32_t axis) {
+    while (hi - lo > 1) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        swap_points(&p[mid], &p[hi - 1]);
+        float pivot = p[hi - 1].v[axis];
+        uint32_t store = lo;
+        for (uint32_t i = lo; i < hi - 1; i++) {
+            if (p[i].v[axis] < pivot) swap_points(&p[i], &p[store++]);
+        }
+        swap_points(&p[store], &p[hi - 1]);
+        if (store == k) return;
+        if (k < store) hi = store;
+        else lo = store + 1;
+    }
+}
+
+static void build_tree(SignatureIndex_t* ix, uint32_t lo, uint32_t hi) {
+    while (hi - lo > LEAF_SIZE) {
+        float min[OD_SIGNATURE_DIMS], max[OD_SIGNATURE_DIMS];
+        for (uint32_t d = 0; d < OD_SIGNATURE_DIMS; d++) min[d] = max[d] = ix->points[lo].v[d];
+        for (uint32_t i = lo + 1; i < hi; i++) {
+            for (uint32_t d = 0; d < OD_SIGNATURE_DIMS; d++) {
+                float x = ix->points[i].v[d];
+                if (x < min[d]) min[d] = x;
+                if (x > max[d]) max[d] = x;
+            }
+        }
+        uint32_t axis = 0;
+        for (uint32_t d = 1; d < OD_SIGNATURE_DIMS; d++) {
+            if (max[d] - min[d] > max[axis] - min[axis]) axis = d;
+        }
+
+        uint32_t mid = lo + (hi - lo) / 2;
+        select_kth(ix->points, lo, hi, mid, axis);
+        ix->axis[mid] = (uint8_t)axis;
+        build_tree(ix, lo, mid);
+        lo = mid + 1;
+    }
+}
+
+static inline float distance2(const float* a, const float* b) {
+#if defined(OD_SIGNATURE_SSE2)
+    __m128 acc = _mm_setzero_ps();
+    for (uint32_t d = 0; d < OD_SIGNATURE_DIMS; d += 4) {
+        __m128 t = _mm_sub_ps(_mm_loadu_ps(a + d), _mm_loadu_ps(b + d));
+        acc = _mm_add_ps(acc, _mm_mul_ps(t, t));
+    }
+    acc = _mm_add_ps(acc, _mm_movehl_ps(acc, acc));
+    acc = _mm_add_ss(acc, _mm_shuffle_ps(acc, acc, 1));
+    return _mm_cvtss_f32(acc);
+#elif defined(OD_SIGNATURE_NEON)
+    float32x4_t acc = vdupq_n_f32(0.0f);
+    for (uint32_t d = 0; d < OD_SIGNATURE_DIMS; d += 4) {
+        float32x4_t t = vsubq_f32(vld1q_f32(a + d), vld1q_f32(b + d));
+        acc = vmlaq_f32(acc, t, t);
+    }
+    float32x2_t s = vadd_f32(vget_low_f32(acc), vget_high_f32(acc));
+    return vget_lane_f32(vpadd_f32(s, s), 0);
+#else
+    float acc = 0.0f;
+    for (uint32_t d = 0; d < OD_SIGNATURE_DIMS; d++) {
+        float t = a[d] - b[d];
+        acc += t * t;
+    }
+    return acc;
+#endif
+}
+
+/* The k best so far, nearest first. */
+typedef struct {
+    float d2[OD_SIGNATURE_K];
+    int32_t id[OD_SIGNATURE_K];
+    uint32_t count;
+} Nearest_t;
+
+static inline float worst(const Nearest_t* best) {
+    return best->count < OD_SIGNATURE_K ? OD_SIGNATURE_MAX_DISTANCE * OD_SIGNATURE_MAX_DISTANCE
+                                        : best->d2[OD_SIGNATURE_K - 1];
+}
+
+static void offer(Nearest_t* best, float d2, int32_t id) {
+    if (d2 >= worst(best)) return;
+    uint32_t i = best->count < OD_SIGNATURE_K ? best->count++ : OD_SIGNATURE_K - 1;
+    for (; i > 0 && best->d2[i - 1] > d2; i--) {
+        best->d2[i] = best->d2[i - 1];
+        best->id[i] = best->id[i - 1];
+    }
+    best->d2[i] = d2;
+    best->id[i] = id;
+}
+
+/* `off` holds the query's offset from the current cell along each axis
+ * and `rd` their squared sum, a lower bound on the distance to anything
+ * in the cell; the far side of a split is skipped once that bound is no
+ * better than the k-th nearest so far. */
+static void search(const SignatureIndex_t* ix, uint32_t lo, uint32_t hi, const float* v, Nearest_t* best,
+                   float* off, float rd) {
+    if (hi - lo <= LEAF_SIZE) {
+        for (uint32_t i = lo; i < hi; i++) offer(best, distance2(ix->points[i].v, v), ix->points[i].id);
+        return;
+    }
+
+    uint32_t mid = lo + (hi - lo) / 2;
+    uint32_t axis = ix->axis[mid];
+    const SignaturePoint_t* p = &ix->points[mid];
+    float diff = v[axis] - p->v[axis];
+    if (diff < 0.0f) search(ix, lo, mid, v, best, off, rd);
+    else search(ix, mid + 1, hi, v, best, off, rd);
+    offer(best, distance2(p->v, v), p->id);
+
+    float old = off[axis];
+    float far_rd = rd - old * old + diff * diff;
+    if (far_rd >= worst(best)) return;
+    off[axis] = diff;
+    if (diff < 0.0f) search(ix, mid + 1, hi, v, best, off, far_rd);
+    else search(ix, lo, mid, v, best, off, far_rd);
+    off[axis] = old;
+}
+
+/* ──────────────────── Lookup ──────────────────── */
+
+uint32_t od_signature_count(void) {
+    atomic_fetch_add(&matching, 1);
+    SignatureIndex_t* ix = atomic_load(&library);
+    uint32_t count = ix ? ix->count : 0;
+    atomic_fetch_sub_explicit(&matching, 1, memory_order_release);
+    return count;
+}
+
+int od_signature_match(const float* v, SignatureMatch_t* match) {
+    Nearest_t best;
+    float off[OD_SIGNATURE_DIMS] = { 0 };
+    best.count = 0;
+
+    atomic_fetch_add(&matching, 1);
+    SignatureIndex_t* ix = atomic_load(&library);
+    if (ix) search(ix, 0, ix->count, v, &best, off, 0.0f);
+    atomic_fetch_sub_explicit(&matching, 1, memory_order_release);
+    if (best.count == 0) return 0;
+
+    /* Neighbours come nearest first, so on a tied vote the signature
+     * holding the closest point wins. */
+    int32_t id[OD_SIGNATURE_K];
+    float vote[OD_SIGNATURE_K];
+    uint32_t ids = 0, winner = 0;
+    for (uint32_t i = 0; i < best.count; i++) {
+        float w = 1.0f - sqrtf(best.d2[i]) / OD_SIGNATURE_MAX_DISTANCE;
+        uint32_t j = 0;
+        while (j < ids && id[j] != best.id[i]) j++;
+        if (j == ids) {
+            id[ids] = best.id[i];
+            vote[ids++] = 0.0f;
+        }
+        vote[j] += w;
+        if (vote[j] > vote[winner]) winner = j;
+    }
+    match->id = id[winner];
+    match->confidence = vote[winner] / (float)OD_SIGNATURE_K;
+    return 1;
+}
+
+int od_signature_fingerprint(FingerprintState_t* fp, const FingerprintPeak_t* peaks, uint32_t count, uint32_t tick,
+                             FingerprintHit_t* hit) {
+    FingerprintPair_t pairs[OD_FP_MAX_PAIRS];
+    uint32_t n = od_fp_push(fp, peaks, count, tick, pairs);
+
+    atomic_fetch_add(&matching, 1);
+    SignatureIndex_t* ix = atomic_load(&library);
+    od_fp_vote(fp, ix ? ix->landmarks : NULL, ix ? ix->landmark_index : NULL, pairs, ix ? n : 0, tick, hit);
+    atomic_fetch_sub_explicit(&matching, 1, memory_order_release);
+
+    for (uint32_t t = 0; t < count; t++) {
+        if (hit[t].id >= 0) return 1;
+    }
+    return 0;
+}
+
+/* ──────────────────── Loading ──────────────────── */
+
+/* What one reference clip adds to the library. */
+typedef struct {
+    SignaturePoint_t* points;
+    uint32_t count;
+    Landmark_t* landmarks;          /* sorted */
+    uint32_t landmark_count;
+} ClipPrints_t;
+
+static void clip_free(ClipPrints_t* clip) {
+    free(clip->points);
+    free(clip->landmarks);
+}
+
+/* Shape vectors and landmarks of the loud frames of a clip, one frame per
+ * fingerprint tick.  Returns the number of frames kept, -1 on error. */
+static int extract_clip(const char* path, int id, ClipPrints_t* clip) {
+    memset(clip, 0, sizeof(*clip));
+    AudioFile_t* file = OD_AudioFile_Open(path, NULL);
+    if (!file) {
+        printf("[Signature] Cannot open %s\n", path);
+        return -1;
+    }
+    const AudioFileInfo_t* info = OD_AudioFile_GetInfo(file);
+    uint32_t hop = (uint32_t)((uint64_t)info->sample_rate * OD_FP_TICK_US / 1000000u);
+    uint32_t size = 64;
+    while (size < hop && size < OD_MAX_FFT_SIZE) size <<= 1;
+    if (hop == 0 || hop > size) hop = size;
+    uint64_t blocks = (info->frames + hop - 1) / hop;
+
+    FFTPlan_t fft;
+    MfccState_t mfcc;
+    FingerprintState_t fp;
+    memset(&mfcc, 0, sizeof(mfcc));
+    od_fp_reset(&fp);
+    if (!od_fft_init(&fft, size)) {
+        OD_AudioFile_Close(file);
+        return -1;
+    }
+    int ok = od_mfcc_build(&mfcc, size, info->sample_rate);
+    size_t slots = (size_t)(blocks ? blocks : 1);
+    SignaturePoint_t* frames = (SignaturePoint_t*)malloc(slots * sizeof(SignaturePoint_t));
+    float* rms = (float*)malloc(slots * sizeof(float));
+    Landmark_t* landmarks = (Landmark_t*)malloc(slots * OD_FP_MAX_PAIRS * sizeof(Landmark_t));
+    uint32_t* landmark_frame = (uint32_t*)malloc(slots * OD_FP_MAX_PAIRS * sizeof(uint32_t));
+    if (!ok || !frames || !rms || !landmarks || !landmark_frame) {
+        printf("[Signature] Cannot analyse %s\n", path);
+        free(frames);
+        free(rms);
+        free(landmarks);
+        free(landmark_frame);
+        od_mfcc_free(&mfcc);
+        od_fft_free(&fft);
+        OD_AudioFile_Close(file);
+        return -1;
+    }
+
+    /* Every channel weighs the same: a reference clip has no direction. */
+    float mono[OD_MAX_FFT_SIZE], power[OD_MAX_FFT_SIZE / 2 + 1];
+    float bin_hz = (float)info->sample_rate / (float)size;
+    float loudest = 0.0f;
+    uint32_t n_frames = 0, n_landmarks = 0;
+    AudioBuffer_t buffer;
+    uint32_t got;
+    while (n_frames < blocks && (got = OD_AudioFile_Read(file, hop, &buffer)) > 0) {
+        float sum_sq = 0.0f;
+        for (uint32_t i = 0; i < got; i++) {
+            float s = 0.0f;
+            for (uint32_t c = 0; c < buffer.channels; c++) s += buffer.buffer[(size_t)i * buffer.channels + c];
+            mono[i] = s / (float)buffer.channels;
+            sum_sq += mono[i] * mono[i];
+        }
+        od_fft_power(&fft, mono, got, power);
+        od_signature_vector(&mfcc, power, frames[n_frames].v);
+        frames[n_frames].id = id;
+        rms[n_frames] = sqrtf(sum_sq / (float)got);
+        if (rms[n_frames] > loudest) loudest = rms[n_frames];
+
+        FingerprintPeak_t peaks[OD_FP_PEAKS];
+        FingerprintPair_t pairs[OD_FP_MAX_PAIRS];
+        uint32_t n_peaks = od_fp_peaks(power, size / 2 + 1, bin_hz, peaks);
+        uint32_t n_pairs = od_fp_push(&fp, peaks, n_peaks, n_frames, pairs);
+        for (uint32_t p = 0; p < n_pairs; p++) {
+            landmarks[n_landmarks].hash = pairs[p].hash;
+            landmarks[n_landmarks].id = id;
+            landmarks[n_landmarks].tick = pairs[p].anchor_tick;
+            landmark_frame[n_landmarks++] = n_frames;
+        }
+        n_frames++;
+    }
+    od_mfcc_free(&mfcc);
+    od_fft_free(&fft);
+    OD_AudioFile_Close(file);
+
+    float gate = loudest * OD_SIGNATURE_GATE;
+    uint32_t kept = 0, kept_landmarks = 0;
+    for (uint32_t i = 0; i < n_landmarks; i++) {
+        if (loudest > 0.0f && rms[landmark_frame[i]] >= gate) landmarks[kept_landmarks++] = landmarks[i];
+    }
+    for (uint32_t i = 0; i < n_frames; i++) {
+        if (loudest > 0.0f && rms[i] >= gate) frames[kept++] = frames[i];
+    }
+    free(rms);
+    free(landmark_frame);
+    qsort(landmarks, kept_landmarks, sizeof(Landmark_t), od_fp_compare);
+
+    /* Long clips are thinned evenly rather than cut short. */
+    uint32_t take = kept < OD_SIGNATURE_MAX_FRAMES ? kept : OD_SIGNATURE_MAX_FRAMES;
+    for (uint32_t i = 0; i < take; i++) frames[i] = frames[(uint64_t)i * kept / take];
+
+    clip->points = frames;
+    clip->count = take;
+    clip->landmarks = landmarks;
+    clip->landmark_count = kept_landmarks;
+    return (int)take;
+}
+
+static void merge_landmarks(const Landmark_t* a, uint32_t na, const Landmark_t* b, uint32_t nb, Landmark_t* out) {
+    uint32_t i = 0, j = 0;
+    while (i < na && j < nb) *out++ = od_fp_compare(&a[i], &b[j]) <= 0 ? a[i++] : b[j++];
+    while (i < na) *out++ = a[i++];
+    while (j < nb) *out++ = b[j++];
+}
+
+int OD_DSP_LoadSignature(int id, const char* file_path) {
+    if (id < 0 || !file_path || !*file_path) return 0;
+
+    ClipPrints_t clip;
+    int added = extract_clip(file_path, id, &clip);
+    if (added <= 0) {
+        if (added == 0) printf("[Signature] %s has no audio\n", file_path);
+        clip_free(&clip);
+        return 0;
+    }
+
+    while (atomic_flag_test_and_set(&loading)) sleep_1ms();
+
+    /* Holding `loading`, nothing else can swap the library out from under us. */
+    SignatureIndex_t* old = atomic_load(&library);
+    uint32_t old_count = old ? old->count : 0, old_landmarks = old ? old->landmark_count : 0;
+    SignatureIndex_t* ix = (SignatureIndex_t*)calloc(1, sizeof(SignatureIndex_t));
+    if (ix) {
+        ix->count = old_count + clip.count;
+        ix->landmark_count = old_landmarks + clip.landmark_count;
+        ix->points = (SignaturePoint_t*)malloc((size_t)ix->count * sizeof(SignaturePoint_t));
+        ix->axis = (uint8_t*)malloc(ix->count);
+        ix->landmarks = (Landmark_t*)malloc(((size_t)ix->landmark_count + 1) * sizeof(Landmark_t));
+        ix->landmark_index = (uint32_t*)malloc((OD_FP_INDEX_SIZE + 1) * sizeof(uint32_t));
+    }
+    if (!ix || !ix->points || !ix->axis || !ix->landmarks || !ix->landmark_index) {
+        atomic_flag_clear(&loading);
+        index_free(ix);
+        clip_free(&clip);
+        return 0;
+    }
+
+    if (old_count) memcpy(ix->points, old->points, (size_t)old_count * sizeof(SignaturePoint_t));
+    memcpy(ix->points + old_count, clip.points, (size_t)clip.count * sizeof(SignaturePoint_t));
+    merge_landmarks(old ? old->landmarks : NULL, old_landmarks, clip.landmarks, clip.landmark_count, ix->landmarks);
+    od_fp_index(ix->landmarks, ix->landmark_count, ix->landmark_index);
+    build_tree(ix, 0, ix->count);
+    /* Once `loading` is clear another load may replace and free `ix`. */
+    uint32_t total = ix->count;
+    swap_library(ix);
+    atomic_flag_clear(&loading);
+
+    printf("[Signature] ID %d: %d frames, %u landmarks from %s (%u frames in library)\n",
+           id, added, clip.landmark_count, file_path, total);
+    clip_free(&clip);
+    return 1;
+}
+
+void OD_DSP_ClearSignatures(void) {
+    while (atomic_flag_test_and_set(&loading)) sleep_1ms();
+    swap_library(NULL);
+    atomic_flag_clear(&loading);
+}
@@ -0,0 +1,66 @@
+#ifndef OD_SIGNATURE_H
+#define OD_SIGNATURE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifdef _WIN32
+#include "dsp_windows.h"
+#else
+#include "dsp.h"
+#endif
+#include "mfcc.h"
+#include "fingerprint.h"
+
+/* Library of reference sounds, matched against each entity by nearest
+ * neighbours.
+ *
+ * A signature is a set of points: the spectral shape of every loud frame
+ * of its reference clips, as cepstral coefficients 1..12 of the log-mel
+ * spectrum (see od_mfcc_shape).  Leaving out c0 makes the shape independent
+ * of level, so a distant shot matches a close recording.  All points share
+ * one KD-tree, stored flat: the node of a range is its middle element,
+ * with the points below it on the split axis to its left, down to small
+ * leaves that are scanned.  Cells farther than the k-th best are pruned,
+ * so a query against 10 000 points costs about a tenth of a full scan.
+ *
+ * The k nearest points within OD_SIGNATURE_MAX_DISTANCE vote for their
+ * signature, each by 1 - d / OD_SIGNATURE_MAX_DISTANCE; the winner's
+ * confidence is its vote total over k.
+ *
+ * The same clips are also indexed as landmark fingerprints (see
+ * fingerprint.h), which identify an exact replay of a sample where the
+ * shape only finds the nearest kind of sound. */
+
+#define OD_SIGNATURE_DIMS           (OD_MFCC_COEFFS - 1)
+#define OD_SIGNATURE_K              5
+#define OD_SIGNATURE_MAX_DISTANCE   4.0f
+#define OD_SIGNATURE_RANGE          1e-4f       /* shape floor, 40 dB below the strongest band */
+#define OD_SIGNATURE_GATE           0.1f        /* clip frames kept: RMS within 20 dB of the loudest */
+#define OD_SIGNATURE_MAX_FRAMES     256         /* points kept per clip */
+
+typedef struct {
+    int id;
+    float confidence;
+} SignatureMatch_t;
+
+/* Shape vector of a power spectrum |X[k]|^2 / n laid out for `mfcc`. */
+void od_signature_vector(const MfccState_t* mfcc, const float* power, float* v);
+
+/* Number of points in the library; 0 when nothing is loaded. */
+uint32_t od_signature_count(void);
+
+/* Returns 1 and fills `match` when a signature is close enough. */
+int od_signature_match(const float* v, SignatureMatch_t* match);
+
+/* Feeds one frame's peaks to a stream's fingerprint matcher at `tick` and
+ * fills hit[] for each peak.  Returns 1 when any peak hit a signature. */
+int od_signature_fingerprint(FingerprintState_t* fp, const FingerprintPeak_t* peaks, uint32_t count, uint32_t tick,
+                             FingerprintHit_t* hit);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,430 @@
+#include "event_log.h"
+#include <math.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+
+#define HEADER_BYTES    8
+#define TAG_SYNC        0x0F
+#define TYPE_ESCAPE     0x0F
+#define MAX_RECORD      48              /* worst-case encoded event */
+#define BATCH_EVENTS    256
+#define QUEUE_EVENTS    8192
+#define POLL_MS         50
+
+/* ──────────────────── Encoding ──────────────────── */
+
+static uint8_t* put_varint(uint8_t* p, uint64_t v) {
+    while (v >= 0x80) {
+        *p++ = (uint8_t)(v | 0x80);
+        v >>= 7;
+    }
+    *p++ = (uint8_t)v;
+    return p;
+}
+
+static uint64_t zigzag(int64_t v) { return ((uint64_t)v << 1) ^ (uint64_t)(v >> 63); }
+static int64_t unzigzag(uint64_t u) { return (int64_t)(u >> 1) ^ -(int64_t)(u & 1); }
+
+static uint8_t quantize_unit(float v) {
+    if (!(v > 0.0f)) return 0;
+    if (v >= 1.0f) return 255;
+    return (uint8_t)lrintf(v * 255.0f);
+}
+
+static uint16_t quantize_azimuth(float degrees) {
+    float turns = degrees / 360.0f;
+    turns -= floorf(turns);
+    return (uint16_t)((uint32_t)lrintf(turns * 65536.0f) & 0xFFFF);
+}
+
+typedef struct {
+    uint64_t timestamp_us;
+    uint32_t track_id;
+} Bases_t;
+
+static uint8_t* encode_sync(uint8_t* p, Bases_t* base, const SoundEvent_t* next) {
+    *p++ = TAG_SYNC;
+    for (int i = 0; i < 8; i++) *p++ = (uint8_t)(next->timestamp_us >> (8 * i));
+    for (int i = 0; i < 4; i++) *p++ = (uint8_t)(next->track_id >> (8 * i));
+    base->timestamp_us = next->timestamp_us;
+    base->track_id = next->track_id;
+    return p;
+}
+
+static uint8_t* encode_event(uint8_t* p, Bases_t* base, const SoundEvent_t* e) {
+    uint32_t type = (e->sound_type >= 0 && e->sound_type < TYPE_ESCAPE) ? (uint32_t)e->sound_type : TYPE_ESCAPE;
+    *p++ = (uint8_t)((e->kind & 0x0F) | (type << 4));
+    if (type == TYPE_ESCAPE) p = put_varint(p, zigzag(e->sound_type));
+
+    p = put_varint(p, zigzag((int64_t)(e->timestamp_us - base->timestamp_us)));
+    uint16_t az = quantize_azimuth(e->azimuth_angle);
+    *p++ = (uint8_t)az;
+    *p++ = (uint8_t)(az >> 8);
+    p = put_varint(p, zigzag((int64_t)lrintf(e->elevation_angle * 100.0f)));
+    *p++ = quantize_unit(e->distance);
+    *p++ = quantize_unit(e->confidence);
+    p = put_varint(p, zigzag((int64_t)e->track_id - (int64_t)base->track_id));
+
+    base->timestamp_us = e->timestamp_us;
+    base->track_id = e->track_id;
+    return p;
+}
+
+/* ──────────────────── Writer ──────────────────── */
+
+struct EventLogWriter {
+    FILE* file;
+    Bases_t base;
+    uint32_t since_sync;
+    int need_sync;
+};
+
+/* A crash can leave the last record half written; appending after it
+ * would make every later record unreadable.  Cuts the file back to the
+ * end of the last complete record, which is where the reader stops.
+ * Returns 0 if the file is not an event log or cannot be cut. */
+static int trim_partial_record(const char* path, uint64_t size) {
+    EventLog_t* log = OD_EventLog_Open(path);
+    if (!log) return 0;
+    EventLogCursor_t cursor = { 0 };
+    SoundEvent_t events[BATCH_EVENTS];
+    while (OD_EventLog_Read(log, NULL, &cursor, events, BATCH_EVENTS) > 0) {}
+    OD_EventLog_Close(log);
+
+    uint64_t valid = cursor.offset < HEADER_BYTES ? HEADER_BYTES : cursor.offset;
+    if (valid >= size) return 1;
+    printf("[Event Log] Dropping %llu bytes of an incomplete record from %s\n",
+           (unsigned long long)(size - valid), path);
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path, GENERIC_WRITE, 0, NULL, OPEN_EXISTING, 0, NULL);
+    if (file == INVALID_HANDLE_VALUE) return 0;
+    LARGE_INTEGER end;
+    end.QuadPart = (LONGLONG)valid;
+    int ok = SetFilePointerEx(file, end, NULL, FILE_BEGIN) && SetEndOfFile(file);
+    CloseHandle(file);
+    return ok;
+#else
+    return truncate(path, (off_t)valid) == 0;
+#endif
+}
+
+EventLogWriter_t* OD_EventLog_Create(const char* path) {
+    if (!path || !*path) return NULL;
+
+    /* Append to an existing log; start a fresh one otherwise. */
+    uint64_t size = 0;
+    FILE* check = fopen(path, "rb");
+    if (check) {
+        fseek(check, 0, SEEK_END);
+        long end = ftell(check);
+        fclose(check);
+        size = end > 0 ? (uint64_t)end : 0;
+    }
+    if (size > 0 && !trim_partial_record(path, size)) {
+        printf("[Event Log] %s exists and is not an event log\n", path);
+        return NULL;
+    }
+
+    FILE* f = fopen(path, "ab");
+    if (!f) {
+        printf("[Event Log] Cannot open %s\n", path);
+        return NULL;
+    }
+    if (size == 0) {
+        uint8_t header[HEADER_BYTES] = { 'O', 'D', 'E', 'V', OD_EVENT_LOG_VERSION, 0, 0, 0 };
+        fwrite(header, 1, sizeof(header), f);
+        fflush(f);
+    }
+
+    EventLogWriter_t* w = (EventLogWriter_t*)calloc(1, sizeof(EventLogWriter_t));
+    if (!w) {
+        fclose(f);
+        return NULL;
+    }
+    w->file = f;
+    w->need_sync = 1;
+    return w;
+}
+
+int OD_EventLog_Append(EventLogWriter_t* w, const SoundEvent_t* events, uint32_t count) {
+    if (!w || !events) return 0;
+    uint8_t out[BATCH_EVENTS * (MAX_RECORD + 13)];
+
+    while (count > 0) {
+        uint32_t n = count < BATCH_EVENTS ? count : BATCH_EVENTS;
+        uint8_t* p = out;
+        for (uint32_t i = 0; i < n; i++) {
+            if (w->need_sync || w->since_sync >= OD_EVENT_LOG_SYNC_INTERVAL) {
+                p = encode_sync(p, &w->base, &events[i]);
+                w->since_sync = 0;
+                w->need_sync = 0;
+            }
+            p = encode_event(p, &w->base, &events[i]);
+            w->since_sync++;
+        }
+        if (fwrite(out, 1, (size_t)(p - out), w->file) != (size_t)(p - out)) {
+            printf("[Event Log] Write failed\n");
+            return 0;
+        }
+        events += n;
+        count -= n;
+    }
+    return 1;
+}
+
+void OD_EventLog_Finish(EventLogWriter_t* w) {
+    if (!w) return;
+    fclose(w->file);
+    free(w);
+}
+
+/* ── Background writer fed from the event stream ── */
+
+static struct {
+    atomic_int active;
+    atomic_int stop;
+    pthread_t thread;
+    EventSubscriber_t* subscriber;
+    EventLogWriter_t* log;
+    _Atomic uint64_t written;
+} writer;
+
+static void sleep_ms(unsigned int ms) {
+#ifdef _WIN32
+    Sleep(ms);
+#else
+    struct timespec ts = { (time_t)(ms / 1000), (long)(ms % 1000) * 1000000L };
+    nanosleep(&ts, NULL);
+#endif
+}
+
+/* Encodes whatever is queued; returns the number of events written. */
+static uint32_t drain(void) {
+    SoundEvent_t batch[BATCH_EVENTS];
+    uint32_t total = 0;
+
+    for (;;) {
+        uint32_t n = OD_Events_Poll(writer.subscriber, batch, BATCH_EVENTS);
+        if (n == 0 || !OD_EventLog_Append(writer.log, batch, n)) break;
+        total += n;
+        atomic_fetch_add_explicit(&writer.written, n, memory_order_relaxed);
+    }
+    if (total) fflush(writer.log->file);
+    return total;
+}
+
+static void* writer_main(void* arg) {
+    (void)arg;
+    while (!atomic_load_explicit(&writer.stop, memory_order_acquire)) {
+        if (drain() == 0) sleep_ms(POLL_MS);
+    }
+    drain();
+    return NULL;
+}
+
+int OD_EventLog_Start(const char* path) {
+    if (atomic_load(&writer.active)) return 0;
+    writer.log = OD_EventLog_Create(path);
+    if (!writer.log) return 0;
+
+    writer.subscriber = OD_Events_Subscribe(QUEUE_EVENTS);
+    if (!writer.subscriber) {
+        OD_EventLog_Finish(writer.log);
+        return 0;
+    }
+    atomic_store(&writer.written, 0);
+    atomic_store(&writer.stop, 0);
+    if (pthread_create(&writer.thread, NULL, writer_main, NULL) != 0) {
+        OD_Events_Unsubscribe(writer.subscriber);
+        OD_EventLog_Finish(writer.log);
+        return 0;
+    }
+    atomic_store(&writer.active, 1);
+    printf("[Event Log] Writing %s\n", path);
+    fflush(stdout);
+    return 1;
+}
+
+void OD_EventLog_Stop(void) {
+    if (!atomic_load(&writer.active)) return;
+    atomic_store_explicit(&writer.stop, 1, memory_order_release);
+    pthread_join(writer.thread, NULL);
+    atomic_store(&writer.active, 0);
+
+    uint64_t dropped = OD_Events_Dropped(writer.subscriber);
+    OD_Events_Unsubscribe(writer.subscriber);
+    writer.subscriber = NULL;
+    OD_EventLog_Finish(writer.log);
+    writer.log = NULL;
+    printf("[Event Log] Stopped: %llu events written, %llu dropped\n",
+           (unsigned long long)atomic_load(&writer.written), (unsigned long long)dropped);
+    fflush(stdout);
+}
+
+int OD_EventLog_IsActive(void) {
+    return atomic_load(&writer.active);
+}
+
+uint64_t OD_EventLog_EventsWritten(void) {
+    return atomic_load_explicit(&writer.written, memory_order_relaxed);
+}
+
+/* ──────────────────── Reader ──────────────────── */
+
+struct EventLog {
+    const uint8_t* map;
+    size_t size;
+#ifdef _WIN32
+    HANDLE file;
+    HANDLE mapping;
+#endif
+};
+
+EventLog_t* OD_EventLog_Open(const char* path) {
+    if (!path) return NULL;
+    EventLog_t* log = (EventLog_t*)calloc(1, sizeof(EventLog_t));
+    if (!log) return NULL;
+
+#ifdef _WIN32
+    log->file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, NULL, OPEN_EXISTING,
+                            FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    LARGE_INTEGER size;
+    if (log->file == INVALID_HANDLE_VALUE || !GetFileSizeEx(log->file, &size) || size.QuadPart < HEADER_BYTES) {
+        OD_EventLog_Close(log);
+        return NULL;
+    }
+    log->mapping = CreateFileMappingA(log->file, NULL, PAGE_READONLY, 0, 0, NULL);
+    log->map = log->mapping ? (const uint8_t*)MapViewOfFile(log->mapping, FILE_MAP_READ, 0, 0, 0) : NULL;
+    log->size = (size_t)size.QuadPart;
+#else
+    int fd = open(path, O_RDONLY);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) != 0 || st.st_size < HEADER_BYTES) {
+        if (fd >= 0) close(fd);
+        free(log);
+        return NULL;
+    }
+    void* p = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (p != MAP_FAILED) {
+        madvise(p, (size_t)st.st_size, MADV_SEQUENTIAL);
+        log->map = (const uint8_t*)p;
+        log->size = (size_t)st.st_size;
+    }
+#endif
+    if (!log->map || memcmp(log->map, OD_EVENT_LOG_MAGIC, 4) != 0 || log->map[4] != OD_EVENT_LOG_VERSION) {
+        printf("[Event Log] %s is not a readable event log\n", path);
+        OD_EventLog_Close(log);
+        return NULL;
+    }
+    return log;
+}
+
+void OD_EventLog_Close(EventLog_t* log) {
+    if (!log) return;
+#ifdef _WIN32
+    if (log->map) UnmapViewOfFile(log->map);
+    if (log->mapping) CloseHandle(log->mapping);
+    if (log->file && log->file != INVALID_HANDLE_VALUE) CloseHandle(log->file);
+#else
+    if (log->map) munmap((void*)log->map, log->size);
+#endif
+    free(log);
+}
+
+/* Returns 0 on a truncated varint. */
+static int get_varint(const uint8_t** p, const uint8_t* end, uint64_t* v) {
+    uint64_t r = 0;
+    for (int shift = 0; shift < 64 && *p < end; shift += 7) {
+        uint8_t b = *(*p)++;
+        r |= (uint64_t)(b & 0x7F) << shift;
+        if (!(b & 0x80)) {
+            *v = r;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+uint32_t OD_EventLog_Read(EventLog_t* log, const EventLogFilter_t* filter,
+                          EventLogCursor_t* cursor, SoundEvent_t* out, uint32_t max) {
+    if (!log || !cursor || !out || max == 0) return 0;
+
+    uint64_t from = filter ? filter->from_us : 0;
+    uint64_t to = (filter && filter->to_us) ? filter->to_us : UINT64_MAX;
+    uint32_t types = filter ? filter->type_mask : 0;
+
+    /* Sector test on the stored u16 azimuth: (az - start) mod 2^16 < width. */
+    int sectored = filter && filter->sector_width > 0.0f && filter->sector_width < 360.0f;
+    uint16_t sector_start = sectored ? quantize_azimuth(filter->sector_start) : 0;
+    uint32_t sector_width = sectored ? (uint32_t)(filter->sector_width / 360.0f * 65536.0f) : 0;
+
+    const uint8_t* p = log->map + (cursor->offset < HEADER_BYTES ? HEADER_BYTES : cursor->offset);
+    const uint8_t* end = log->map + log->size;
+    uint64_t ts = cursor->timestamp_us;
+    uint32_t track = cursor->track_id;
+    uint32_t n = 0;
+
+    while (n < max && p < end) {
+        const uint8_t* record = p;
+        uint8_t tag = *p++;
+        uint32_t kind = tag & 0x0F;
+
+        if (kind == TAG_SYNC) {
+            if (end - p < 12) { p = record; break; }
+            ts = 0;
+            for (int i = 0; i < 8; i++) ts |= (uint64_t)p[i] << (8 * i);
+            track = (uint32_t)p[8] | ((uint32_t)p[9] << 8) | ((uint32_t)p[10] << 16) | ((uint32_t)p[11] << 24);
+            p += 12;
+            continue;
+        }
+
+        uint64_t v, dt, elev, dtrack;
+        int64_t type = tag >> 4;
+        if (type == TYPE_ESCAPE) {
+            if (!get_varint(&p, end, &v)) { p = record; break; }
+            type = unzigzag(v);
+        }
+        if (!get_varint(&p, end, &dt) || end - p < 2) { p = record; break; }
+        uint16_t az = (uint16_t)(p[0] | (p[1] << 8));
+        p += 2;
+        if (!get_varint(&p, end, &elev) || end - p < 2) { p = record; break; }
+        uint8_t dist = p[0], conf = p[1];
+        p += 2;
+        if (!get_varint(&p, end, &dtrack)) { p = record; break; }
+
+        ts += (uint64_t)unzigzag(dt);
+        track = (uint32_t)((int64_t)track + unzigzag(dtrack));
+
+        if (ts < from || ts >= to) continue;
+        if (types && (type < 0 || type >= 32 || !(types & (1u << type)))) continue;
+        if (sectored && (uint16_t)(az - sector_start) >= sector_width) continue;
+
+        SoundEvent_t* e = &out[n++];
+        e->timestamp_us = ts;
+        e->azimuth_angle = (float)az * (360.0f / 65536.0f);
+        e->elevation_angle = (float)unzigzag(elev) * 0.01f;
+        e->distance = (float)dist / 255.0f;
+        e->confidence = (float)conf / 255.0f;
+        e->sound_type = (int32_t)type;
+        e->track_id = track;
+        e->kind = kind;
+    }
+
+    cursor->offset = (uint64_t)(p - log->map);
+    cursor->timestamp_us = ts;
+    cursor->track_id = track;
+    return n;
+}
@@ -0,0 +1,75 @@
+#ifndef OD_EVENT_LOG_H
+#define OD_EVENT_LOG_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "events.h"
+
+/* Append-only binary log of sound events, and a memory-mapped reader.
+ *
+ *  File:    "ODEV" u8 version, 3 reserved bytes, then records.
+ *  Record:  tag byte; low nibble kind (15 = sync), high nibble sound
+ *           type (15 = escaped, varint follows).
+ *    event  zigzag varint timestamp delta (us), u16 azimuth (1/65536 turn),
+ *           zigzag varint elevation (1/100 degree), u8 distance,
+ *           u8 confidence (both 1/255), zigzag varint track id delta
+ *    sync   u64 timestamp, u32 track id: absolute bases for the deltas
+ *
+ * The writer emits a sync record when it starts and every
+ * OD_EVENT_LOG_SYNC_INTERVAL events, so appending a new session to an
+ * old file just works, and a reader that meets a torn tail (the process
+ * died mid-write) stops there.  A typical event takes ~10 bytes. */
+
+#define OD_EVENT_LOG_MAGIC          "ODEV"
+#define OD_EVENT_LOG_VERSION        1
+#define OD_EVENT_LOG_SYNC_INTERVAL  4096
+
+/* ── Writer for events the caller already has (one thread per writer) ── */
+
+typedef struct EventLogWriter EventLogWriter_t;
+
+/* Opens `path` for appending, writing the header if the file is new. */
+OD_API EventLogWriter_t* OD_EventLog_Create(const char* path);
+OD_API int  OD_EventLog_Append(EventLogWriter_t* writer, const SoundEvent_t* events, uint32_t count);
+OD_API void OD_EventLog_Finish(EventLogWriter_t* writer);
+
+/* ── Background writer subscribed to the event stream ── */
+
+OD_API int  OD_EventLog_Start(const char* path);
+OD_API void OD_EventLog_Stop(void);
+OD_API int  OD_EventLog_IsActive(void);
+OD_API uint64_t OD_EventLog_EventsWritten(void);
+
+/* ── Reader ── */
+
+typedef struct EventLog EventLog_t;
+
+typedef struct {
+    uint64_t from_us;           /* inclusive */
+    uint64_t to_us;             /* exclusive; 0 = no upper bound */
+    uint32_t type_mask;         /* bit per SoundType_t; 0 = every type */
+    float sector_start;         /* degrees, clockwise from front */
+    float sector_width;         /* degrees; 0 or >= 360 = every direction */
+} EventLogFilter_t;
+
+typedef struct {
+    uint64_t offset;            /* zero-initialise to read from the start */
+    uint64_t timestamp_us;
+    uint32_t track_id;
+} EventLogCursor_t;
+
+OD_API EventLog_t* OD_EventLog_Open(const char* path);
+OD_API void OD_EventLog_Close(EventLog_t* log);
+
+/* Copies up to `max` events matching `filter` (NULL = all) into `out`,
+ * continuing from `cursor`.  Returns the number copied; 0 at the end. */
+OD_API uint32_t OD_EventLog_Read(EventLog_t* log, const EventLogFilter_t* filter,
+                                 EventLogCursor_t* cursor, SoundEvent_t* out, uint32_t max);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
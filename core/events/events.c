@@ -0,0 +1,138 @@
+#include "events.h"
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+#define MAX_SUBSCRIBERS 16
+
+/* ──────────────────── Bounded MPSC queue ────────────────────
+ *
+ *  Vyukov's bounded queue: each cell carries a sequence number that
+ *  tells producers whether it is free for position `pos` and tells the
+ *  consumer whether the event in it has been fully written.  Producers
+ *  claim a position with one CAS on `tail`; the single consumer owns
+ *  `head` outright.
+ */
+
+typedef struct {
+    _Atomic uint64_t sequence;
+    SoundEvent_t event;
+} Cell_t;
+
+struct EventSubscriber {
+    Cell_t* cells;
+    uint64_t mask;
+    _Atomic uint64_t tail;                      /* next position to claim (producers) */
+    uint64_t head;                              /* next position to read (consumer) */
+    _Atomic uint64_t dropped;
+};
+
+static int queue_push(EventSubscriber_t* q, const SoundEvent_t* event) {
+    uint64_t pos = atomic_load_explicit(&q->tail, memory_order_relaxed);
+    for (;;) {
+        Cell_t* cell = &q->cells[pos & q->mask];
+        uint64_t seq = atomic_load_explicit(&cell->sequence, memory_order_acquire);
+        int64_t diff = (int64_t)(seq - pos);
+        if (diff == 0) {
+            if (atomic_compare_exchange_weak_explicit(&q->tail, &pos, pos + 1,
+                                                      memory_order_relaxed, memory_order_relaxed)) {
+                cell->event = *event;
+                atomic_store_explicit(&cell->sequence, pos + 1, memory_order_release);
+                return 1;
+            }
+        } else if (diff < 0) {
+            return 0;                           /* full */
+        } else {
+            pos = atomic_load_explicit(&q->tail, memory_order_relaxed);
+        }
+    }
+}
+
+static int queue_pop(EventSubscriber_t* q, SoundEvent_t* event) {
+    Cell_t* cell = &q->cells[q->head & q->mask];
+    uint64_t seq = atomic_load_explicit(&cell->sequence, memory_order_acquire);
+    if (seq != q->head + 1) return 0;           /* empty, or still being written */
+    *event = cell->event;
+    atomic_store_explicit(&cell->sequence, q->head + q->mask + 1, memory_order_release);
+    q->head++;
+    return 1;
+}
+
+/* ──────────────────── Subscribers ──────────────────── */
+
+static _Atomic(EventSubscriber_t*) subscribers[MAX_SUBSCRIBERS];
+static atomic_int publishing;                   /* producers inside od_events_publish */
+
+static void sleep_1ms(void) {
+#ifdef _WIN32
+    Sleep(1);
+#else
+    struct timespec ts = { 0, 1000000L };
+    nanosleep(&ts, NULL);
+#endif
+}
+
+EventSubscriber_t* OD_Events_Subscribe(uint32_t capacity) {
+    uint64_t size = 16;
+    while (size < capacity && size < (1u << 20)) size <<= 1;
+
+    EventSubscriber_t* q = (EventSubscriber_t*)calloc(1, sizeof(EventSubscriber_t));
+    if (!q) return NULL;
+    q->cells = (Cell_t*)calloc((size_t)size, sizeof(Cell_t));
+    if (!q->cells) {
+        free(q);
+        return NULL;
+    }
+    q->mask = size - 1;
+    for (uint64_t i = 0; i < size; i++) atomic_init(&q->cells[i].sequence, i);
+
+    for (int i = 0; i < MAX_SUBSCRIBERS; i++) {
+        EventSubscriber_t* expected = NULL;
+        if (atomic_compare_exchange_strong(&subscribers[i], &expected, q)) return q;
+    }
+    printf("[Events] Too many subscribers (max %d)\n", MAX_SUBSCRIBERS);
+    free(q->cells);
+    free(q);
+    return NULL;
+}
+
+void OD_Events_Unsubscribe(EventSubscriber_t* subscriber) {
+    if (!subscriber) return;
+    for (int i = 0; i < MAX_SUBSCRIBERS; i++) {
+        EventSubscriber_t* expected = subscriber;
+        if (atomic_compare_exchange_strong(&subscribers[i], &expected, NULL)) break;
+    }
+    /* A producer may still hold the pointer it loaded before the slot was
+     * cleared; wait it out before freeing. */
+    while (atomic_load_explicit(&publishing, memory_order_acquire) != 0) sleep_1ms();
+    free(subscriber->cells);
+    free(subscriber);
+}
+
+uint32_t OD_Events_Poll(EventSubscriber_t* subscriber, SoundEvent_t* out, uint32_t max) {
+    if (!subscriber || !out) return 0;
+    uint32_t n = 0;
+    while (n < max && queue_pop(subscriber, &out[n])) n++;
+    return n;
+}
+
+uint64_t OD_Events_Dropped(const EventSubscriber_t* subscriber) {
+    return subscriber ? atomic_load_explicit(&subscriber->dropped, memory_order_relaxed) : 0;
+}
+
+void od_events_publish(const SoundEvent_t* event) {
+    if (!event) return;
+    atomic_fetch_add_explicit(&publishing, 1, memory_order_acq_rel);
+    for (int i = 0; i < MAX_SUBSCRIBERS; i++) {
+        EventSubscriber_t* q = atomic_load_explicit(&subscribers[i], memory_order_acquire);
+        if (q && !queue_push(q, event)) {
+            atomic_fetch_add_explicit(&q->dropped, 1, memory_order_relaxed);
+        }
+    }
+    atomic_fetch_sub_explicit(&publishing, 1, memory_order_release);
+}
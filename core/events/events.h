@@ -0,0 +1,56 @@
+#ifndef OD_EVENTS_H
+#define OD_EVENTS_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "../../include/od_export.h"
+#include <stdint.h>
+
+/* Discrete sound events.
+ *
+ * The DSP reports an onset when a sound appears (or jumps in level) at a
+ * direction, tagged with the id of the direction track it belongs to.
+ * Every subscriber has its own bounded lock-free MPSC queue: producers
+ * (any number of DSP contexts) never block or allocate, and each event
+ * reaches each subscriber exactly once, so a consumer can poll at display
+ * rate without missing a one-block gunshot.  A full queue drops the new
+ * event and counts it. */
+
+typedef enum {
+    SOUND_EVENT_ONSET = 0,
+} SoundEventKind_t;
+
+typedef struct {
+    uint64_t timestamp_us;      /* capture time of the block (monotonic clock) */
+    float azimuth_angle;
+    float elevation_angle;
+    float distance;
+    float confidence;
+    int32_t sound_type;         /* SoundType_t */
+    uint32_t track_id;
+    uint32_t kind;              /* SoundEventKind_t */
+} SoundEvent_t;
+
+typedef struct EventSubscriber EventSubscriber_t;
+
+/* `capacity` is rounded up to a power of two (minimum 16). */
+OD_API EventSubscriber_t* OD_Events_Subscribe(uint32_t capacity);
+OD_API void OD_Events_Unsubscribe(EventSubscriber_t* subscriber);
+
+/* Moves up to `max` queued events into `out`, oldest first.  One thread
+ * per subscriber.  Returns the number copied. */
+OD_API uint32_t OD_Events_Poll(EventSubscriber_t* subscriber, SoundEvent_t* out, uint32_t max);
+OD_API uint64_t OD_Events_Dropped(const EventSubscriber_t* subscriber);
+
+/* Delivers one event to every current subscriber.  Wait-free for the
+ * caller apart from the per-queue CAS.  This is the default event sink of
+ * a DSP context. */
+void od_events_publish(const SoundEvent_t* event);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,301 @@
+#include "history.h"
+#include "../driver/capture_backend.h"
+#include <math.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SECTOR_DEGREES  (360.0f / OD_HISTORY_SECTORS)
+#define MAX_TYPES       32
+#define NO_BUCKET       UINT64_MAX
+
+/* ──────────────────── State ────────────────────
+ *
+ *  Links are sequence numbers plus one (0 = none): entry `seq` lives in
+ *  ring[seq & mask] until `written` passes seq + capacity, so a link is
+ *  still good iff written - seq <= capacity.
+ */
+
+typedef struct {
+    SoundEvent_t event;
+    uint64_t prev_in_sector;
+    uint32_t sector;
+} Entry_t;
+
+static struct {
+    pthread_mutex_t lock;
+    int active;
+    EventSubscriber_t* subscriber;
+
+    Entry_t* ring;
+    uint64_t capacity;
+    uint64_t written;
+    uint64_t window_us;
+    uint64_t newest_us;
+
+    uint64_t sector_head[OD_HISTORY_SECTORS];
+    uint64_t type_head[MAX_TYPES];
+
+    uint32_t* counts;                           /* [bucket][sector] */
+    uint64_t* bucket_id;                        /* absolute bucket number held by each row */
+    uint64_t buckets;
+} history = { .lock = PTHREAD_MUTEX_INITIALIZER };
+
+static uint32_t sector_of(float azimuth) {
+    float a = fmodf(azimuth, 360.0f);
+    if (a < 0.0f) a += 360.0f;
+    uint32_t s = (uint32_t)(a / SECTOR_DEGREES);
+    return s < OD_HISTORY_SECTORS ? s : OD_HISTORY_SECTORS - 1;
+}
+
+static const Entry_t* entry_at(uint64_t link) {
+    if (link == 0 || history.written - (link - 1) > history.capacity) return NULL;
+    return &history.ring[(link - 1) & (history.capacity - 1)];
+}
+
+static uint32_t* bucket_row(uint64_t bucket) {
+    uint64_t row = bucket & (history.buckets - 1);
+    return history.bucket_id[row] == bucket ? &history.counts[row * OD_HISTORY_SECTORS] : NULL;
+}
+
+/* ──────────────────── Ingest ──────────────────── */
+
+static void insert(const SoundEvent_t* e) {
+    uint64_t seq = history.written;
+    Entry_t* slot = &history.ring[seq & (history.capacity - 1)];
+
+    if (seq >= history.capacity) {
+        uint32_t* row = bucket_row(slot->event.timestamp_us / OD_HISTORY_BUCKET_US);
+        if (row && row[slot->sector]) row[slot->sector]--;
+    }
+
+    uint32_t sector = sector_of(e->azimuth_angle);
+    slot->event = *e;
+    slot->sector = sector;
+    slot->prev_in_sector = history.sector_head[sector];
+    history.sector_head[sector] = seq + 1;
+    if (e->sound_type >= 0 && e->sound_type < MAX_TYPES) history.type_head[e->sound_type] = seq + 1;
+
+    uint64_t bucket = e->timestamp_us / OD_HISTORY_BUCKET_US;
+    uint32_t* row = bucket_row(bucket);
+    if (!row) {
+        uint64_t r = bucket & (history.buckets - 1);
+        history.bucket_id[r] = bucket;
+        row = &history.counts[r * OD_HISTORY_SECTORS];
+        memset(row, 0, OD_HISTORY_SECTORS * sizeof(uint32_t));
+    }
+    row[sector]++;
+
+    if (e->timestamp_us > history.newest_us) history.newest_us = e->timestamp_us;
+    history.written = seq + 1;
+}
+
+static void drain(void) {
+    SoundEvent_t batch[64];
+    uint32_t n;
+    while ((n = OD_Events_Poll(history.subscriber, batch, 64)) > 0) {
+        for (uint32_t i = 0; i < n; i++) insert(&batch[i]);
+    }
+}
+
+static uint64_t now_locked(void) {
+    uint64_t now = (uint64_t)(od_capture_clock() * 1e6);
+    return now > history.newest_us ? now : history.newest_us;
+}
+
+/* Oldest timestamp a query may return. */
+static uint64_t horizon(uint64_t now, uint32_t window_ms) {
+    uint64_t window = history.window_us;
+    if (window_ms && (uint64_t)window_ms * 1000u < window) window = (uint64_t)window_ms * 1000u;
+    return now > window ? now - window : 0;
+}
+
+/* Sectors covering [start, start + width), as a first index and count. */
+static uint32_t sector_span(float start, float width, uint32_t* first) {
+    if (!(width > 0.0f) || width >= 360.0f) {
+        *first = 0;
+        return OD_HISTORY_SECTORS;
+    }
+    float a = fmodf(start, 360.0f);
+    if (a < 0.0f) a += 360.0f;
+    float lo = floorf(a / SECTOR_DEGREES);
+    float hi = ceilf((a + width) / SECTOR_DEGREES);
+    uint32_t count = (uint32_t)(hi - lo);
+    *first = (uint32_t)lo % OD_HISTORY_SECTORS;
+    return count < OD_HISTORY_SECTORS ? count : OD_HISTORY_SECTORS;
+}
+
+/* ──────────────────── API ──────────────────── */
+
+int OD_History_Start(uint32_t seconds, uint32_t capacity) {
+    if (seconds == 0 || capacity == 0) return 0;
+    pthread_mutex_lock(&history.lock);
+    if (history.active) {
+        pthread_mutex_unlock(&history.lock);
+        return 0;
+    }
+
+    uint64_t size = 16;
+    while (size < capacity && size < (1u << 20)) size <<= 1;
+    uint64_t window_us = (uint64_t)seconds * 1000000u;
+    uint64_t buckets = 4;
+    while (buckets < window_us / OD_HISTORY_BUCKET_US + 2) buckets <<= 1;
+
+    history.ring = (Entry_t*)calloc((size_t)size, sizeof(Entry_t));
+    history.counts = (uint32_t*)calloc((size_t)(buckets * OD_HISTORY_SECTORS), sizeof(uint32_t));
+    history.bucket_id = (uint64_t*)malloc((size_t)buckets * sizeof(uint64_t));
+    history.subscriber = OD_Events_Subscribe(size > 1024 ? (uint32_t)size : 1024);
+    if (!history.ring || !history.counts || !history.bucket_id || !history.subscriber) {
+        if (history.subscriber) OD_Events_Unsubscribe(history.subscriber);
+        free(history.ring);
+        free(history.counts);
+        free(history.bucket_id);
+        history.ring = NULL;
+        history.counts = NULL;
+        history.bucket_id = NULL;
+        history.subscriber = NULL;
+        pthread_mutex_unlock(&history.lock);
+        return 0;
+    }
+    for (uint64_t i = 0; i < buckets; i++) history.bucket_id[i] = NO_BUCKET;
+    memset(history.sector_head, 0, sizeof(history.sector_head));
+    memset(history.type_head, 0, sizeof(history.type_head));
+    history.capacity = size;
+    history.buckets = buckets;
+    history.window_us = window_us;
+    history.written = 0;
+    history.newest_us = 0;
+    history.active = 1;
+    pthread_mutex_unlock(&history.lock);
+
+    printf("[History] Keeping %us / %llu events\n", seconds, (unsigned long long)size);
+    fflush(stdout);
+    return 1;
+}
+
+void OD_History_Stop(void) {
+    pthread_mutex_lock(&history.lock);
+    if (history.active) {
+        OD_Events_Unsubscribe(history.subscriber);
+        free(history.ring);
+        free(history.counts);
+        free(history.bucket_id);
+        history.subscriber = NULL;
+        history.ring = NULL;
+        history.counts = NULL;
+        history.bucket_id = NULL;
+        history.active = 0;
+    }
+    pthread_mutex_unlock(&history.lock);
+}
+
+int OD_History_IsActive(void) {
+    pthread_mutex_lock(&history.lock);
+    int active = history.active;
+    pthread_mutex_unlock(&history.lock);
+    return active;
+}
+
+void OD_History_Update(void) {
+    pthread_mutex_lock(&history.lock);
+    if (history.active) drain();
+    pthread_mutex_unlock(&history.lock);
+}
+
+uint64_t OD_History_Now(void) {
+    pthread_mutex_lock(&history.lock);
+    uint64_t now = now_locked();
+    pthread_mutex_unlock(&history.lock);
+    return now;
+}
+
+uint32_t OD_History_Query(uint64_t now_us, uint32_t window_ms,
+                          float sector_start, float sector_width, uint32_t type_mask,
+                          SoundEvent_t* out, uint32_t max) {
+    if (!out || max == 0) return 0;
+    pthread_mutex_lock(&history.lock);
+    if (!history.active) {
+        pthread_mutex_unlock(&history.lock);
+        return 0;
+    }
+    drain();
+
+    uint64_t from = horizon(now_us ? now_us : now_locked(), window_ms);
+    uint32_t first;
+    uint32_t span = sector_span(sector_start, sector_width, &first);
+
+    /* Merge the per-sector chains newest first, by sequence number. */
+    uint64_t cursor[OD_HISTORY_SECTORS];
+    for (uint32_t i = 0; i < span; i++) cursor[i] = history.sector_head[(first + i) % OD_HISTORY_SECTORS];
+
+    uint32_t n = 0;
+    while (n < max) {
+        int pick = -1;
+        for (uint32_t i = 0; i < span; i++) {
+            const Entry_t* e = entry_at(cursor[i]);
+            if (!e || e->event.timestamp_us < from) {
+                cursor[i] = 0;                  /* chain is time-ordered: nothing older qualifies */
+                continue;
+            }
+            if (pick < 0 || cursor[i] > cursor[pick]) pick = (int)i;
+        }
+        if (pick < 0) break;
+
+        const Entry_t* e = entry_at(cursor[pick]);
+        cursor[pick] = e->prev_in_sector;
+        int32_t type = e->event.sound_type;
+        if (type_mask && (type < 0 || type >= MAX_TYPES || !(type_mask & (1u << type)))) continue;
+        out[n++] = e->event;
+    }
+    pthread_mutex_unlock(&history.lock);
+    return n;
+}
+
+uint32_t OD_History_Count(uint64_t now_us, uint32_t window_ms, float sector_start, float sector_width) {
+    pthread_mutex_lock(&history.lock);
+    if (!history.active) {
+        pthread_mutex_unlock(&history.lock);
+        return 0;
+    }
+    drain();
+
+    uint64_t now = now_us ? now_us : now_locked();
+    uint64_t from = horizon(now, window_ms);
+    uint32_t first;
+    uint32_t span = sector_span(sector_start, sector_width, &first);
+
+    uint32_t total = 0;
+    for (uint64_t b = from / OD_HISTORY_BUCKET_US; b <= now / OD_HISTORY_BUCKET_US; b++) {
+        const uint32_t* row = bucket_row(b);
+        if (!row) continue;
+        for (uint32_t i = 0; i < span; i++) total += row[(first + i) % OD_HISTORY_SECTORS];
+    }
+    pthread_mutex_unlock(&history.lock);
+    return total;
+}
+
+int OD_History_Latest(uint32_t type_mask, SoundEvent_t* out) {
+    if (!out) return 0;
+    pthread_mutex_lock(&history.lock);
+    if (!history.active) {
+        pthread_mutex_unlock(&history.lock);
+        return 0;
+    }
+    drain();
+
+    uint64_t link = 0;
+    if (type_mask == 0) {
+        link = history.written;                 /* newest entry overall */
+    } else {
+        for (int t = 0; t < MAX_TYPES; t++) {
+            if ((type_mask & (1u << t)) && history.type_head[t] > link) link = history.type_head[t];
+        }
+    }
+
+    const Entry_t* e = entry_at(link);
+    int found = e && e->event.timestamp_us >= horizon(now_locked(), 0);
+    if (found) *out = e->event;
+    pthread_mutex_unlock(&history.lock);
+    return found;
+}
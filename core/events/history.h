@@ -0,0 +1,65 @@
+#ifndef OD_HISTORY_H
+#define OD_HISTORY_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "events.h"
+
+/* The last few seconds of sound events, indexed by direction and time.
+ *
+ * Events land in a preallocated ring.  Each ring entry links to the
+ * previous event in the same azimuth sector, so a sector query walks
+ * only the events it returns; a (time bucket × sector) count grid
+ * answers "how many" without touching events at all; and the newest
+ * event of every sound type is kept by reference.  Nothing allocates
+ * after OD_History_Start.
+ *
+ * The history subscribes to the event stream and drains it on every
+ * call, so it only needs someone to query it (or call OD_History_Update)
+ * more often than its queue fills.  Calls may come from any thread.
+ *
+ * Times are on the capture clock (SoundEvent_t.timestamp_us); a `now_us`
+ * of 0 means OD_History_Now().  Azimuths are degrees clockwise from the
+ * front, so "behind me" is the sector starting at 135 with width 90. */
+
+#define OD_HISTORY_SECTORS      16              /* 22.5 degrees each */
+#define OD_HISTORY_BUCKET_US    250000u
+
+/* `seconds` of history, at most `capacity` events (rounded up to a power
+ * of two); older events fall out whichever limit is hit first. */
+OD_API int  OD_History_Start(uint32_t seconds, uint32_t capacity);
+OD_API void OD_History_Stop(void);
+OD_API int  OD_History_IsActive(void);
+
+/* Drains pending events into the ring.  Queries do this themselves. */
+OD_API void OD_History_Update(void);
+
+/* Current time on the capture clock, or the newest event if that is
+ * later (replayed streams can run ahead of the wall clock). */
+OD_API uint64_t OD_History_Now(void);
+
+/* Events from the last `window_ms` (0 = whole history) whose azimuth
+ * falls in [sector_start, sector_start + sector_width) and whose type is
+ * in `type_mask` (0 = every type), newest first.  Sector bounds are
+ * rounded out to whole index sectors; width 0 or >= 360 = every
+ * direction.  Returns the number copied. */
+OD_API uint32_t OD_History_Query(uint64_t now_us, uint32_t window_ms,
+                                 float sector_start, float sector_width, uint32_t type_mask,
+                                 SoundEvent_t* out, uint32_t max);
+
+/* How many events the query above would find, from the count grid.
+ * Resolution is one time bucket: the oldest bucket counts in full. */
+OD_API uint32_t OD_History_Count(uint64_t now_us, uint32_t window_ms,
+                                 float sector_start, float sector_width);
+
+/* Newest event of any type in `type_mask` (0 = any) that is still in the
+ * history.  Returns 1 and fills `out` if there is one. */
+OD_API int OD_History_Latest(uint32_t type_mask, SoundEvent_t* out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
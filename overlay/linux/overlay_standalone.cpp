@@ -4,18 +4,27 @@
 #include "imgui_impl_opengl3.h"
 #include "../osd_radar.h"
 #include "../../core/driver/capture.h"
+#include "../../core/driver/recorder.h"
 #include "../../core/dsp/dsp.h"
+#include "../../core/events/event_log.h"
+#include "../../core/events/history.h"
+#include "../../core/dsp/analysis.h"
 #include "../../core/dsp/classifier.h"
 #include "../../hardware/serial_controller.h"
 #include <iostream>
 #include <csignal>
+#include <cstdlib>
 #include <chrono>
 #include <thread>
+#include <vector>
 
 static GLFWwindow* overlay_window = nullptr;
+static volatile std::sig_atomic_t quit_requested = 0;
 
+/* Only flags the request; the render loop sees it and shuts down on the
+ * main thread, where the recorder and event log can be stopped safely. */
 void signal_handler(int signal) {
-    exit(0);
+    quit_requested = 1;
 }
 
 int main(int argc, char** argv) {
@@ -32,10 +41,21 @@ int main(int argc, char** argv) {
     float range_scale = 1.0f;
     float radar_size = 280.0f;
     int poll_rate = 60;
+    int idle_rate = 10;
+    bool gate_enabled = true;
+    float gate_dbfs = -60.0f;
     int max_entities = 4;
     int channels = 2;
     std::string preset = "none";
+    std::string model_path = "";
+    std::vector<std::string> signatures;
     std::string hw_port = "";
+    std::string capture_spec = "native";
+    std::string record_path = "";
+    std::string event_log_path = "";
+    int history_seconds = 5;
+    DSPConfig_t dsp_config;
+    OD_DSP_DefaultConfig(&dsp_config);
     for (int i = 1; i < argc; i++) {
         std::string arg(argv[i]);
         if (arg == "--fullscreen") fullscreen_mode = true;
@@ -52,10 +72,37 @@ int main(int argc, char** argv) {
         }
         if (arg.rfind("--range=", 0) == 0) range_scale = std::atof(argv[i] + 8) / 50.0f; 
         if (arg.rfind("--pollrate=", 0) == 0) poll_rate = std::atoi(argv[i] + 11);
-        if (arg.rfind("--channels=", 0) == 0) channels = std::atoi(argv[i] + 11);
+        if (arg.rfind("--idle-rate=", 0) == 0) idle_rate = std::atoi(argv[i] + 12);
+        if (arg.rfind("--history=", 0) == 0) history_seconds = std::atoi(argv[i] + 10);
+        if (arg.rfind("--gate=", 0) == 0) {
+            /* "--gate=off" keeps the DSP and full frame rate running in silence */
+            gate_enabled = (arg != "--gate=off");
+            if (gate_enabled) gate_dbfs = std::atof(argv[i] + 7);
+        }
+        if (arg.rfind("--channels=", 0) == 0) {
+            /* "auto" (or 0) keeps the sink's native layout and rate */
+            channels = (arg == "--channels=auto") ? 0 : std::atoi(argv[i] + 11);
+        }
         if (arg.rfind("--hw-port=", 0) == 0) hw_port = arg.substr(10);
+        if (arg.rfind("--capture=", 0) == 0) capture_spec = arg.substr(10);
+        if (arg.rfind("--record=", 0) == 0) record_path = arg.substr(9);
+        if (arg.rfind("--event-log=", 0) == 0) event_log_path = arg.substr(12);
         if (arg.rfind("--preset=", 0) == 0) preset = arg.substr(9);
+        if (arg.rfind("--model=", 0) == 0) model_path = arg.substr(8);
+        if (arg.rfind("--signature=", 0) == 0) signatures.push_back(arg.substr(12));   /* <id>:<path> */
+        if (arg.rfind("--fft=", 0) == 0) dsp_config.fft_size = (uint32_t)std::atoi(argv[i] + 6);
+        if (arg == "--decimate") dsp_config.min_analysis_rate = 44100;
+        if (arg.rfind("--decimate=", 0) == 0) dsp_config.min_analysis_rate = (uint32_t)std::atoi(argv[i] + 11);
+        if (arg.rfind("--layout=", 0) == 0) {
+            if (!OD_DSP_ParseChannelMap(argv[i] + 9, &dsp_config.channel_map))
+                std::cerr << "[OD Overlay] Ignoring invalid channel layout " << arg << std::endl;
+        }
+        if (arg.rfind("--bands=", 0) == 0) {
+            if (!OD_DSP_ParseBandLayout(argv[i] + 8, &dsp_config.bands))
+                std::cerr << "[OD Overlay] Ignoring invalid band layout " << arg << std::endl;
+        }
     }
+    if (dsp_config.channel_map.channels > 0) channels = (int)dsp_config.channel_map.channels;
     std::signal(SIGINT, signal_handler);
 
     if (!glfwInit()) return -1;
@@ -83,11 +130,48 @@ int main(int argc, char** argv) {
     ImGui_ImplOpenGL3_Init("#version 330");
 
     
+    if (!OD_Capture_SelectBackend(capture_spec.c_str()))
+        std::cerr << "[OD Overlay] Unknown capture backend, using native" << std::endl;
+    if (!record_path.empty()) {
+        if (!OD_Recorder_Start(record_path.c_str()))
+            std::cerr << "[OD Overlay] Could not start recorder for " << record_path << std::endl;
+    }
+    if (!event_log_path.empty()) {
+        if (!OD_EventLog_Start(event_log_path.c_str()))
+            std::cerr << "[OD Overlay] Could not start event log " << event_log_path << std::endl;
+    }
+    if (gate_enabled && !OD_Capture_SetGate(gate_dbfs, gate_dbfs - 6.0f, 500))
+        std::cerr << "[OD Overlay] Ignoring invalid gate level " << gate_dbfs << " dBFS" << std::endl;
     OD_Capture_Init(channels);
     OD_Capture_Start();
 
     OD_Classifier_Init();
     OD_Classifier_SetPreset(preset.c_str());
+    if (!model_path.empty() && !OD_Classifier_LoadModel(model_path.c_str()))
+        std::cerr << "[OD Overlay] Could not load model " << model_path << ", using the preset rules" << std::endl;
+    for (const std::string& spec : signatures) {
+        size_t colon = spec.find(':');
+        if (colon == std::string::npos || !OD_DSP_LoadSignature(std::atoi(spec.c_str()), spec.c_str() + colon + 1))
+            std::cerr << "[OD Overlay] Could not load signature " << spec << std::endl;
+    }
+
+    dsp_config.channels = (uint32_t)channels;
+    DSPContext_t* dsp_ctx = OD_DSP_CreateContext(&dsp_config);
+    if (!dsp_ctx) {
+        std::cerr << "[OD Overlay] Invalid DSP configuration, using defaults" << std::endl;
+        dsp_ctx = OD_DSP_CreateContext(nullptr);
+    }
+
+    /* Recent onsets, drawn as a fading trail and replayed to the hardware
+     * when the live snapshot missed them.  Started before the analysis
+     * thread so the first event is kept too. */
+    if (history_seconds > 0 && !OD_History_Start((uint32_t)history_seconds, 1024))
+        std::cerr << "[OD Overlay] Could not start the event history" << std::endl;
+
+    /* DSP runs on the engine's analysis thread at audio cadence; this
+     * loop only draws the newest result. */
+    if (!OD_Analysis_Start(dsp_ctx, sensitivity, separation))
+        std::cerr << "[OD Overlay] Could not start the analysis thread" << std::endl;
 
     bool hw_enabled = false;
     if (!hw_port.empty()) {
@@ -100,23 +184,40 @@ int main(int argc, char** argv) {
     }
 
     auto frame_duration = std::chrono::duration<double>(1.0 / (poll_rate > 0 ? poll_rate : 60));
+    auto idle_duration = std::chrono::duration<double>(1.0 / (idle_rate > 0 ? idle_rate : 10));
+    static constexpr int MAX_TRAIL = 64;
+    RadarTrail_t trail[MAX_TRAIL];
+    uint64_t hw_replayed_us = 0;
 
-    while (!glfwWindowShouldClose(overlay_window)) {
+    while (!quit_requested && !glfwWindowShouldClose(overlay_window)) {
         auto start_time = std::chrono::steady_clock::now();
 
         glfwPollEvents();
 
         
-        AudioBuffer_t* buffer = OD_Capture_GetLatestBuffer();
         SpatialData_t dsp_data = {};
-        memset(&dsp_data, 0, sizeof(SpatialData_t));
-        if (buffer && buffer->buffer) {
-            dsp_data = OD_DSP_ProcessBuffer(buffer, sensitivity, separation);
-            
-            
-            if (hw_enabled && dsp_data.entity_count > 0) {
-                
-                OD_Hardware_SendDirectionLog(dsp_data.entities[0].azimuth_angle);
+        bool fresh = OD_Analysis_GetLatest(&dsp_data);
+        bool hw_sent = false;
+        if (fresh && hw_enabled && dsp_data.entity_count > 0) {
+            OD_Hardware_SendDirectionLog(dsp_data.entities[0].azimuth_angle);
+            hw_sent = true;
+        }
+
+        int trail_count = 0;
+        if (OD_History_IsActive()) {
+            SoundEvent_t past[MAX_TRAIL];
+            uint64_t now_us = OD_History_Now();
+            uint32_t n = OD_History_Query(now_us, 0, 0.0f, 0.0f, 0, past, MAX_TRAIL);
+            for (uint32_t i = 0; i < n; i++) {
+                trail[trail_count++] = { past[i].azimuth_angle, past[i].distance, past[i].sound_type,
+                                         (float)(now_us - past[i].timestamp_us) / (history_seconds * 1e6f) };
+            }
+
+            /* A one-block shot can fall between two frames; replay it. */
+            SoundEvent_t last;
+            if (OD_History_Latest(0, &last) && last.timestamp_us != hw_replayed_us) {
+                if (hw_enabled && !hw_sent) OD_Hardware_SendDirectionLog(last.azimuth_angle);
+                hw_replayed_us = last.timestamp_us;
             }
         }
 
@@ -126,7 +227,8 @@ int main(int argc, char** argv) {
 
         
         
-        DrawRadarHUD(&dsp_data, fullscreen_mode, osd_opacity, radar_opacity, dot_opacity, max_entities, range_scale, osd_position, radar_size);
+        DrawRadarHUD(&dsp_data, fullscreen_mode, osd_opacity, radar_opacity, dot_opacity, max_entities, range_scale, osd_position, radar_size,
+                     trail, trail_count);
 
         ImGui::Render();
         int display_w, display_h;
@@ -141,12 +243,24 @@ int main(int argc, char** argv) {
         
         auto end_time = std::chrono::steady_clock::now();
         auto elapsed = end_time - start_time;
-        if (elapsed < frame_duration) {
+        if (OD_Capture_IsIdle()) {
+            /* Silence: drop to the idle cadence, but wake as soon as the
+             * gate opens; the block that opened it is kept for us. */
+            if (elapsed < idle_duration) {
+                auto wait = std::chrono::duration_cast<std::chrono::milliseconds>(idle_duration - elapsed);
+                OD_Capture_WaitForActivity((uint32_t)wait.count());
+            }
+        } else if (elapsed < frame_duration) {
             std::this_thread::sleep_for(frame_duration - elapsed);
         }
     }
 
+    OD_Analysis_Stop();
     OD_Capture_Stop();
+    OD_Recorder_Stop();
+    OD_EventLog_Stop();
+    OD_History_Stop();
+    OD_DSP_DestroyContext(dsp_ctx);
     ImGui_ImplOpenGL3_Shutdown();
     ImGui_ImplGlfw_Shutdown();
     ImGui::DestroyContext();
@@ -13,6 +13,7 @@ static float blip_azimuth[MAX_BLIPS] = {0};
 static float blip_distance[MAX_BLIPS] = {0.5f, 0.5f, 0.5f, 0.5f, 0.5f, 0.5f, 0.5f, 0.5f, 0.5f, 0.5f};
 static float blip_alpha[MAX_BLIPS] = {0};
 static int blip_type[MAX_BLIPS] = {0}; 
+static float blip_elevation[MAX_BLIPS] = {0};
 
 static void DrawSoundIcon(ImDrawList* dl, ImVec2 pos, float size, int type, ImU32 col, int ba) {
     float s = size;
@@ -44,8 +45,35 @@ static void DrawSoundIcon(ImDrawList* dl, ImVec2 pos, float size, int type, ImU3
     }
 }
 
+/* Small chevron above (sound overhead) or below (sound underneath) a blip. */
+static void DrawElevationHint(ImDrawList* dl, ImVec2 pos, float size, float elevation, ImU32 col) {
+    if (fabsf(elevation) < 15.0f) return;
+    float s = size * 0.5f;
+    if (elevation > 0.0f) {
+        float y = pos.y - size * 1.6f;
+        dl->AddTriangleFilled({pos.x, y - s}, {pos.x - s, y + s * 0.5f}, {pos.x + s, y + s * 0.5f}, col);
+    } else {
+        float y = pos.y + size * 1.6f;
+        dl->AddTriangleFilled({pos.x, y + s}, {pos.x + s, y - s * 0.5f}, {pos.x - s, y - s * 0.5f}, col);
+    }
+}
+
+/* History marks sit under the live blips and fade out with age. */
+static void DrawTrail(ImDrawList* dl, ImVec2 center, float radius, float range, float size, const RadarTrail_t* trail, int trail_count, int alpha) {
+    for (int i = 0; i < trail_count; i++) {
+        float fade = 1.0f - trail[i].age;
+        if (fade <= 0.0f) continue;
+        float angle_rad = (trail[i].azimuth - 90.0f) * (3.14159f / 180.0f);
+        float d = trail[i].distance * radius * range;
+        if (d > radius) d = radius;
+        ImVec2 pos = ImVec2(center.x + cosf(angle_rad) * d, center.y + sinf(angle_rad) * d);
+        int ta = (int)(alpha * fade * fade * 0.5f);
+        DrawSoundIcon(dl, pos, size, trail[i].type, IM_COL32(200, 200, 200, ta), ta);
+    }
+}
 
-void DrawRadarHUD(SpatialData_t* data, bool is_fullscreen, float global_opacity, float radar_opacity, float dot_opacity, int max_entities, float range, int position, float radar_size) {
+void DrawRadarHUD(SpatialData_t* data, bool is_fullscreen, float global_opacity, float radar_opacity, float dot_opacity, int max_entities, float range, int position, float radar_size,
+                  const RadarTrail_t* trail, int trail_count) {
     ImGuiIO& io = ImGui::GetIO();
     float dt = io.DeltaTime;
     
@@ -80,6 +108,7 @@ void DrawRadarHUD(SpatialData_t* data, bool is_fullscreen, float global_opacity,
             blip_distance[i] += (target_dist - blip_distance[i]) * dt * 8.0f;
             blip_alpha[i] = 1.0f;
             blip_type[i] = data->entities[i].sound_type;
+            blip_elevation[i] += (data->entities[i].elevation_angle - blip_elevation[i]) * dt * 8.0f;
         } else {
             
             
@@ -111,6 +140,8 @@ void DrawRadarHUD(SpatialData_t* data, bool is_fullscreen, float global_opacity,
         dl->AddLine(ImVec2(center.x, center.y - ch), ImVec2(center.x, center.y + ch), 
                     IM_COL32(255, 255, 255, (int)(rh_alpha * 0.15f)), 1.0f);
 
+        DrawTrail(dl, center, radius, range, 8.0f, trail, trail_count, (int)(alpha * dot_opacity));
+
         
         for (int i = 0; i < max_entities; i++) {
             if (blip_alpha[i] < 0.01f) continue;
@@ -128,6 +159,7 @@ void DrawRadarHUD(SpatialData_t* data, bool is_fullscreen, float global_opacity,
             
             dl->AddCircleFilled(pos, 22.0f, IM_COL32(r_col, g_col, 20, (int)(ba * 0.15f)));
             DrawSoundIcon(dl, pos, 12.0f, blip_type[i], IM_COL32(r_col, g_col, 20, ba), ba);
+            DrawElevationHint(dl, pos, 12.0f, blip_elevation[i], IM_COL32(255, 255, 255, ba));
             dl->AddCircle(pos, 22.0f, IM_COL32(255, 255, 255, (int)(ba * 0.1f)), 24, 1.0f);
         }
 
@@ -188,6 +220,8 @@ void DrawRadarHUD(SpatialData_t* data, bool is_fullscreen, float global_opacity,
         dl->AddText(ImVec2(center.x + radius + 4, center.y - 5), IM_COL32(255, 255, 255, (int)(alpha * radar_opacity * 0.5f)), "R");
         dl->AddText(ImVec2(center.x - radius - 12, center.y - 5), IM_COL32(255, 255, 255, (int)(alpha * radar_opacity * 0.5f)), "L");
 
+        DrawTrail(dl, center, radius, range, 4.0f, trail, trail_count, (int)(alpha * dot_opacity));
+
         
         for (int i = 0; i < max_entities; i++) {
             if (blip_alpha[i] < 0.01f) continue;
@@ -208,6 +242,7 @@ void DrawRadarHUD(SpatialData_t* data, bool is_fullscreen, float global_opacity,
 
             dl->AddCircleFilled(pos, 12.0f, col_glow);
             DrawSoundIcon(dl, pos, 6.0f, blip_type[i], col_core, ba);
+            DrawElevationHint(dl, pos, 6.0f, blip_elevation[i], IM_COL32(255, 255, 255, ba));
         }
 
         ImGui::End();
@@ -3,7 +3,15 @@
 
 #include "../core/dsp/dsp.h"
 
+/* A past event drawn as a fading mark; age runs from 0 (now) to 1 (about to drop out). */
+struct RadarTrail_t {
+    float azimuth;
+    float distance;
+    int type;
+    float age;
+};
 
-void DrawRadarHUD(SpatialData_t* data, bool is_fullscreen, float global_opacity, float radar_opacity, float dot_opacity, int max_entities, float range, int position, float radar_size);
+void DrawRadarHUD(SpatialData_t* data, bool is_fullscreen, float global_opacity, float radar_opacity, float dot_opacity, int max_entities, float range, int position, float radar_size,
+                  const RadarTrail_t* trail = nullptr, int trail_count = 0);
 
 #endif 
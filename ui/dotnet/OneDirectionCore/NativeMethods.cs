@@ -24,6 +24,7 @@ namespace OneDirectionCore
             public int SignatureMatchId;
             public float Confidence;
             public int SoundType;
+            public float ElevationAngle;
         }
 
         [StructLayout(LayoutKind.Sequential)]
@@ -78,6 +79,9 @@ namespace OneDirectionCore
         [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
         public static extern int OD_DSP_LoadSignature(int id, [MarshalAs(UnmanagedType.LPStr)] string filePath);
 
+        [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
+        public static extern void OD_DSP_ClearSignatures();
+
         
         [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
         public static extern void OD_Classifier_Init();
@@ -85,6 +89,12 @@ namespace OneDirectionCore
         [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
         public static extern void OD_Classifier_SetPreset([MarshalAs(UnmanagedType.LPStr)] string presetName);
 
+        [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
+        public static extern int OD_Classifier_LoadPreset([MarshalAs(UnmanagedType.LPStr)] string filePath);
+
+        [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
+        public static extern int OD_Classifier_LoadModel([MarshalAs(UnmanagedType.LPStr)] string filePath);
+
         [DllImport(DllName, CallingConvention = CallingConvention.Cdecl)]
         public static extern IntPtr OD_Classifier_TypeName(int type);
 